@@ -0,0 +1,139 @@
+#ifndef SEPARATORS_HPP
+#define SEPARATORS_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline unsigned count_trailing_zeros(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Classifies 64 bytes at a time into a bitmask (bit i set - data[i] is a separator).
+// AVX2 and SSE2 paths compare the block against every separator char; other targets use a lookup table.
+class SeparatorSet
+{
+    static constexpr size_t max_simd_separators = 16;
+
+    std::array<bool, 256> table_{};
+    std::array<char, max_simd_separators> chars_{};
+    size_t count_ = 0;
+
+public:
+    explicit constexpr SeparatorSet(std::string_view separators)
+    {
+        for (char c : separators)
+        {
+            if (!table_[static_cast<unsigned char>(c)])
+            {
+                table_[static_cast<unsigned char>(c)] = true;
+
+                if (count_ < max_simd_separators)
+                    chars_[count_] = c;
+                ++count_;
+            }
+        }
+    }
+
+    constexpr bool contains(char c) const
+    {
+        return table_[static_cast<unsigned char>(c)];
+    }
+
+    // requires 64 readable bytes at data
+    uint64_t mask64(const char* data) const
+    {
+        if (count_ > max_simd_separators)
+            return mask64_scalar(data);
+
+#if defined(__AVX2__)
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+        __m256i match_lo = _mm256_setzero_si256();
+        __m256i match_hi = _mm256_setzero_si256();
+
+        for (size_t i = 0; i < count_; ++i)
+        {
+            __m256i separator = _mm256_set1_epi8(chars_[i]);
+            match_lo = _mm256_or_si256(match_lo, _mm256_cmpeq_epi8(lo, separator));
+            match_hi = _mm256_or_si256(match_hi, _mm256_cmpeq_epi8(hi, separator));
+        }
+
+        return static_cast<uint32_t>(_mm256_movemask_epi8(match_lo))
+            | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(match_hi))) << 32);
+#elif defined(__SSE2__) || defined(_M_X64)
+        uint64_t mask = 0;
+
+        for (size_t block = 0; block < 4; ++block)
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + block * 16));
+            __m128i match = _mm_setzero_si128();
+
+            for (size_t i = 0; i < count_; ++i)
+                match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(chars_[i])));
+
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(match))) << (block * 16);
+        }
+
+        return mask;
+#else
+        return mask64_scalar(data);
+#endif
+    }
+
+    uint64_t mask64_scalar(const char* data) const
+    {
+        uint64_t mask = 0;
+
+        for (size_t i = 0; i < 64; ++i)
+            mask |= static_cast<uint64_t>(contains(data[i])) << i;
+
+        return mask;
+    }
+
+    const char* find_first_separator(const char* first, const char* last) const
+    {
+        for (; last - first >= 64; first += 64)
+        {
+            if (uint64_t mask = mask64(first); mask != 0)
+                return first + count_trailing_zeros(mask);
+        }
+
+        while (first != last && !contains(*first))
+            ++first;
+
+        return first;
+    }
+
+    const char* find_first_not_separator(const char* first, const char* last) const
+    {
+        for (; last - first >= 64; first += 64)
+        {
+            if (uint64_t mask = ~mask64(first); mask != 0)
+                return first + count_trailing_zeros(mask);
+        }
+
+        while (first != last && contains(*first))
+            ++first;
+
+        return first;
+    }
+};
+
+#endif
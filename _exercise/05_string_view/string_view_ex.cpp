@@ -6,35 +6,41 @@
 #include <vector>
 
 #include "catch.hpp"
+#include "separators.hpp"
 
 using namespace std;
 
-std::vector<std::string_view> split_text(std::string&& text, string_view separators = " ,;") = delete;
+std::vector<std::string_view> split_text(std::string&& text, const SeparatorSet& separators) = delete;
 
-std::vector<std::string_view> split_text(string_view text, string_view separators = " ,;" )
+std::vector<std::string_view> split_text(string_view text, const SeparatorSet& separators)
 {
-    std::vector<std::string_view> tokens;   
+    std::vector<std::string_view> tokens;
 
-    auto pos1 = cbegin(text);
+    auto pos1 = text.data();
+    const auto text_end = text.data() + text.size();
 
-    while(pos1 != cend(text))
+    while(pos1 != text_end)
     {
-        auto pos2 = std::find_first_of(pos1, cend(text), cbegin(separators), cend(separators));
+        auto pos2 = separators.find_first_separator(pos1, text_end);
 
-        auto token_starts = &(*pos1);
-        auto token_length = pos2 - pos1;
+        tokens.emplace_back(pos1, pos2 - pos1);
 
-        tokens.emplace_back(token_starts, token_length);
-
-        if (pos2 == cend(text))
+        if (pos2 == text_end)
             break;
-        
+
         pos1 = std::next(pos2);
     }
 
     return tokens;
 }
 
+std::vector<std::string_view> split_text(std::string&& text, string_view separators = " ,;") = delete;
+
+std::vector<std::string_view> split_text(string_view text, string_view separators = " ,;" )
+{
+    return split_text(text, SeparatorSet{separators});
+}
+
 TEST_CASE("split with spaces")
 {
     string text = "one two three four";
@@ -56,3 +62,18 @@ TEST_CASE("split with commas")
 
     REQUIRE(equal(begin(expected), end(expected), begin(words)));
 }
+
+TEST_CASE("split with separator set")
+{
+    const SeparatorSet separators{" ,;"};
+    string text = "one;;two, three" + string(100, ' ') + "four";
+
+    auto words = split_text(text, separators);
+
+    REQUIRE(words.size() == 105);
+    REQUIRE(words[0] == "one");
+    REQUIRE(words[1] == "");
+    REQUIRE(words[2] == "two");
+    REQUIRE(words[4] == "three");
+    REQUIRE(words.back() == "four");
+}
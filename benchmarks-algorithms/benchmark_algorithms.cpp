@@ -3,14 +3,41 @@
 
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <execution>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <optional>
 #include <random>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
+
+#include "binary_corpus.hpp"
+#include "case_folding.hpp"
+#include "corpus.hpp"
+#include "external_sort.hpp"
+#include "factorization.hpp"
+#include "fast_hash.hpp"
+#include "memoization.hpp"
+#include "miller_rabin.hpp"
+#include "parallel_merge_sort.hpp"
+#include "prime_sieve.hpp"
+#include "scaling.hpp"
+#include "datasets.hpp"
+#include "execution_backends.hpp"
+#include "string_pool.hpp"
+#include "string_sort.hpp"
+#include "symbol_table.hpp"
+#include "token_stream.hpp"
+#include "trial_division.hpp"
+#include "word_count.hpp"
 
 using DocumentContent = std::vector<std::string>;
 
@@ -31,84 +58,918 @@ std::optional<DocumentContent> load_words(const std::string &file_name)
     return words;
 }
 
-inline const DocumentContent words = [] { DocumentContent words = load_words("tokens.txt").value(); words.resize(words.size() / 10);  return words; }();
+// tokens.bin, rebuilt from tokens.txt only when it is missing or stale - startup does not parse the text
+const BinaryCorpus& token_source()
+{
+    static const BinaryCorpus tokens = open_corpus("tokens.txt", "tokens.bin");
+    return tokens;
+}
+
+// raw text of tokens.txt for the text kernels (tokenizer, hashing, case folding), mapped on first use
+std::string_view token_text()
+{
+    static const MappedFile file = MappedFile::open("tokens.txt").value();
+    return file.content();
+}
+
+// the corpus is repeated as many times as needed to reach the requested size
+template <typename Tokens>
+void repeat_to_size(Tokens& tokens, size_t size)
+{
+    const size_t source_size = tokens.size();
+    tokens.reserve(size);
+
+    for (size_t i = source_size; i < size; ++i)
+        tokens.push_back(tokens[i % source_size]);
+
+    tokens.resize(size);
+}
+
+const bool datasets_registered = [] {
+    auto& registry = datasets();
+
+    registry.set_size("words", 20'000);
+    registry.set_size("numbers", 20'000);
+    registry.set_size("numbers_full_range", 20'000);
+
+    registry.add<DocumentContent>("words", [](size_t size) {
+        DocumentContent words(token_source().begin(), token_source().end());
+        repeat_to_size(words, size);
+        return words;
+    });
+
+    registry.add<DocumentView>("words", [](size_t size) {
+        auto corpus = open_corpus("tokens.txt", "tokens.bin");
+        std::vector<std::string_view> tokens(corpus.begin(), corpus.end());
+        repeat_to_size(tokens, size);
+        return std::move(corpus).into_view(std::move(tokens));
+    });
+
+    registry.add<StringPool>("words", [](size_t size) {
+        const auto& words = datasets().get<DocumentView>("words", size);
+        return StringPool{words.begin(), words.end()};
+    });
+
+    registry.add<InternedDocument>("words", [](size_t size) {
+        return intern_words(datasets().get<DocumentContent>("words", size));
+    });
+
+    registry.add<std::vector<uint64_t>>("numbers", [](size_t size) {
+        std::random_device rd;
+        std::mt19937_64 rnd_gen{rd()};
+        std::uniform_int_distribution<uint64_t> rnd_distr(0, size);
+
+        std::vector<uint64_t> numbers(size);
+        std::generate(numbers.begin(), numbers.end(), [&] { return rnd_distr(rnd_gen); });
+
+        return numbers;
+    });
+
+    registry.add<std::vector<uint64_t>>("numbers_full_range", [](size_t size) {
+        std::random_device rd;
+        std::mt19937_64 rnd_gen{rd()};
+        std::uniform_int_distribution<uint64_t> rnd_distr; // [0, 2^64)
+
+        std::vector<uint64_t> numbers(size);
+        std::generate(numbers.begin(), numbers.end(), [&] { return rnd_distr(rnd_gen); });
+
+        return numbers;
+    });
+
+    return true;
+}();
+
+template <typename Document>
+const Document& corpus()
+{
+    return datasets().get<Document>("words");
+}
+
+ThreadPool& benchmark_pool()
+{
+    static ThreadPool pool{std::thread::hardware_concurrency()};
+    return pool;
+}
+
+// Every timed run gets its own copy of input, made before the measurement starts, so copying is not timed
+// and no run sees data already sorted/partitioned by the previous one; returns the copies after the runs
+template <typename Input, typename Function>
+std::vector<Input> measure_on_fresh_copies(Catch::Benchmark::Chronometer& meter, const Input& input, Function f)
+{
+    std::vector<Input> copies(meter.runs(), input);
+    meter.measure([&](int run) { return f(copies[run]); });
+    return copies;
+}
+
+std::string to_lower_copy(std::string_view word)
+{
+    std::string lowered(word);
+    boost::to_lower(lowered);
+    return lowered;
+}
 
 TEST_CASE("hardware concurrency")
 {
     std::cout << "No of cores: " << std::thread::hardware_concurrency() << "\n";
-    std::cout << "No of words: " << words.size() << std::endl;
+    std::cout << "No of words: " << datasets().size("words") << "\n";
+    std::cout << "No of numbers: " << datasets().size("numbers") << "\n";
+    std::cout << "No of numbers (full range): " << datasets().size("numbers_full_range") << std::endl;
 }
 
-TEST_CASE("accumulate")
+TEST_CASE("scaling - serial fraction")
 {
-    auto calc_hash = [](const auto &item) { return std::hash<std::remove_cv_t<std::remove_reference_t<decltype(item)>>>{}(item); };
+    REQUIRE(thread_count_sweep(1) == std::vector<size_t>{1});
+    REQUIRE(thread_count_sweep(6) == std::vector<size_t>{1, 2, 4, 6});
+
+    // 10% serial part: T(p) = 0.1 + 0.9 / p
+    const auto points = scaling_points({1, 2, 4}, {1.0, 0.55, 0.325});
+    REQUIRE(points[1].speedup == Approx(1.0 / 0.55));
+    REQUIRE(points[2].efficiency == Approx(1.0 / 0.325 / 4));
+    REQUIRE_FALSE(points[0].serial_fraction);
+    REQUIRE(*points[1].serial_fraction == Approx(0.1));
+    REQUIRE(*points[2].serial_fraction == Approx(0.1));
+
+    REQUIRE(run_with_threads(1, [] { return 42; }) == 42);
+
+    ThreadArenas arenas{{1, 2}};
+    REQUIRE(arenas.run(2, [] { return 42; }) == 42);
+    REQUIRE_THROWS_AS(arenas.run(3, [] { return 42; }), std::out_of_range);
+#if defined(SCALING_HAS_TBB_ARENA)
+    REQUIRE(arenas.run(2, [] { return tbb::this_task_arena::max_concurrency(); }) == 2);
+#endif
+
+    // setup is not timed
+    const auto setup_only = measure_scaling([] { std::this_thread::sleep_for(std::chrono::milliseconds{20}); return 0; }, [](size_t, int) {}, {1}, 3);
+    REQUIRE(setup_only[0].seconds < 0.01);
+}
+
+TEST_CASE("memory usage")
+{
+    const auto& words = corpus<DocumentContent>();
+    const auto& words_view = corpus<DocumentView>();
+    const auto& words_pool = corpus<StringPool>();
+
+    size_t content_bytes = words.capacity() * sizeof(std::string);
+    for (const auto &word : words)
+        if (word.capacity() > std::string{}.capacity()) // longer than the small string buffer
+            content_bytes += word.capacity() + 1;
+
+    const size_t view_bytes = words_view.size() * sizeof(std::string_view);
+
+    std::cout << "DocumentContent: " << content_bytes << " bytes\n";
+    std::cout << "DocumentView: " << view_bytes << " bytes + mapped file\n";
+    std::cout << "StringPool: " << words_pool.memory_usage() << " bytes" << std::endl;
+
+    REQUIRE(std::equal(words.begin(), words.end(), words_pool.begin(), words_pool.end()));
+}
+
+TEST_CASE("load")
+{
+    const auto words = load_words("tokens.txt").value();
+    const auto words_view = load_words_mapped("tokens.txt").value();
 
-    BENCHMARK("std::accumulate")
+    REQUIRE(std::equal(words.begin(), words.end(), words_view.begin(), words_view.end()));
+
+    BENCHMARK("ifstream >> std::string")
     {
-        return std::accumulate(words.begin(), words.end(), 0ULL, [=](const auto &total, const auto &word) { return total + calc_hash(word);; });
+        return load_words("tokens.txt")->size();
     };
 
-    BENCHMARK("std::transform_reduce - parallel")
+    BENCHMARK("mmap + std::string_view")
     {
-        return std::transform_reduce(std::execution::par, words.begin(), words.end(), 0ULL, std::plus{}, calc_hash);
+        return load_words_mapped("tokens.txt")->size();
     };
 
-    BENCHMARK("std::transform_reduce - parallel unsequenced")
+    REQUIRE(std::equal(words_view.begin(), words_view.end(), token_source().begin(), token_source().end()));
+
+    // the dataset is the file cut or repeated to the dataset size
+    const auto& dataset = corpus<DocumentView>();
+    size_t no_of_mismatches = 0;
+    for (size_t i = 0; i < dataset.size(); ++i)
+        no_of_mismatches += dataset[i] != words_view[i % words_view.size()];
+    REQUIRE(no_of_mismatches == 0);
+
+    BENCHMARK("mmap binary corpus")
     {
-        return std::transform_reduce(std::execution::par, words.begin(), words.end(), 0ULL, std::plus{}, calc_hash);
+        return BinaryCorpus::open("tokens.bin")->size();
+    };
+}
+
+TEST_CASE("binary corpus - missing or stale file")
+{
+    const std::string file_name = "tokens_rebuilt.bin";
+    std::filesystem::remove(file_name);
+
+    {
+        const auto rebuilt = open_corpus("tokens.txt", file_name); // missing - parsed and written
+        REQUIRE(std::equal(rebuilt.begin(), rebuilt.end(), token_source().begin(), token_source().end()));
+    }
+    REQUIRE(open_corpus("tokens.txt", file_name).size() == token_source().size()); // up to date - opened as is
+
+    std::filesystem::resize_file(file_name, sizeof(CorpusHeader) + 1); // no mapping of the file is alive here
+    std::filesystem::last_write_time(file_name, std::filesystem::last_write_time("tokens.txt") - std::chrono::hours{1});
+    REQUIRE(open_corpus("tokens.txt", file_name).size() == token_source().size()); // stale - rebuilt
+
+    std::filesystem::remove(file_name);
+}
+
+TEST_CASE("binary corpus - corrupt files")
+{
+    const auto valid_file = MappedFile::open("tokens.bin").value();
+    const std::string valid{valid_file.content()};
+    const std::string corrupt_file_name = "tokens_corrupt.bin";
+
+    auto open_corrupt = [&](const std::string &bytes) {
+        std::ofstream{corrupt_file_name, std::ios::binary}.write(bytes.data(), bytes.size());
+        return BinaryCorpus::open(corrupt_file_name);
     };
+
+    auto with_field = [&](size_t offset, uint64_t value) {
+        auto bytes = valid;
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+        return bytes;
+    };
+
+    REQUIRE_FALSE(BinaryCorpus::open("missing.bin"));
+    REQUIRE(open_corrupt(valid)->size() == token_source().size());
+
+    REQUIRE_THROWS_AS(open_corrupt(valid.substr(0, valid.size() / 2)), std::runtime_error);
+    REQUIRE_THROWS_AS(open_corrupt(valid.substr(0, sizeof(CorpusHeader) - 1)), std::runtime_error);
+
+    CorpusHeader header;
+    std::memcpy(&header, valid.data(), sizeof(header));
+
+    // (no_of_tokens + 1) * 8 wraps around to 0 and no_of_chars covers the rest of the file
+    auto overflowing = with_field(offsetof(CorpusHeader, no_of_tokens), (uint64_t{1} << 61) - 1);
+    const uint64_t rest_of_file = valid.size() - sizeof(CorpusHeader);
+    std::memcpy(overflowing.data() + offsetof(CorpusHeader, no_of_chars), &rest_of_file, sizeof(rest_of_file));
+    REQUIRE_THROWS_AS(open_corrupt(overflowing), std::runtime_error);
+
+    const size_t offsets_begin = sizeof(CorpusHeader);
+    REQUIRE_THROWS_AS(open_corrupt(with_field(offsets_begin, 1)), std::runtime_error);
+    REQUIRE_THROWS_AS(open_corrupt(with_field(offsets_begin + sizeof(uint64_t), uint64_t{1} << 40)), std::runtime_error);
+    REQUIRE_THROWS_AS(open_corrupt(with_field(offsets_begin + header.no_of_tokens * sizeof(uint64_t), header.no_of_chars + 1)), std::runtime_error);
+
+    std::filesystem::remove(corrupt_file_name);
 }
 
-TEST_CASE("sort")
+std::vector<std::string_view> split_words_find_first_of(std::string_view text)
 {
-    BENCHMARK_ADVANCED("sequenced")
+    const std::string_view separators = " \n\t\r\v\f";
+    std::vector<std::string_view> tokens;
+
+    for (auto pos1 = text.begin(); pos1 != text.end();)
+    {
+        auto pos2 = std::find_first_of(pos1, text.end(), separators.begin(), separators.end());
+
+        if (pos2 != pos1)
+            tokens.emplace_back(&(*pos1), pos2 - pos1);
+
+        if (pos2 == text.end())
+            break;
+
+        pos1 = std::next(pos2);
+    }
+
+    return tokens;
+}
+
+TEST_CASE("tokenize")
+{
+    const auto text = token_text();
+    std::cout << "Text size: " << text.size() << " bytes" << std::endl;
+
+    REQUIRE(split_words(text) == split_words_find_first_of(text));
+
+    std::string tokens_across_blocks = "\t";
+    for (size_t length = 1; length <= 130; ++length)
+        tokens_across_blocks += std::string(length, 'x') + std::string(length % 3 + 1, ' ');
+    REQUIRE(split_words(tokens_across_blocks) == split_words_find_first_of(tokens_across_blocks));
+    tokens_across_blocks.pop_back();
+    REQUIRE(split_words(tokens_across_blocks) == split_words_find_first_of(tokens_across_blocks));
+
+    REQUIRE(split_words_parallel(text) == split_words(text));
+    REQUIRE(split_words_parallel(text, 64) == split_words(text));
+
+    BENCHMARK("std::find_first_of")
+    {
+        return split_words_find_first_of(text).size();
+    };
+
+    BENCHMARK("separator mask")
+    {
+        return split_words(text).size();
+    };
+
+    BENCHMARK("separator mask - parallel")
+    {
+        return split_words_parallel(text).size();
+    };
+}
+
+TEST_CASE("fast hash")
+{
+    const auto& symbols = corpus<InternedDocument>().symbols;
+
+    std::vector<uint64_t> hashes(symbols.size());
+    for (WordId id = 0; id < symbols.size(); ++id)
+        hashes[id] = FastHash{}(symbols.text(id));
+    std::sort(hashes.begin(), hashes.end());
+    REQUIRE(std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end());
+
+    std::string long_text{token_text().substr(0, 64 * 1024)};
+    const auto* data = reinterpret_cast<const uint8_t*>(long_text.data());
+    for (size_t size : {0, 1, 3, 4, 8, 16, 17, 128, 129, 191, 192, 193, 1024, 1025, 64 * 1024})
+    {
+        REQUIRE(FastHash{}(std::string_view(long_text).substr(0, size)) == fast_hash(long_text.data(), size));
+
+        if (size > FastHashing::long_input_threshold)
+            REQUIRE(fast_hash(data, size, 42) == FastHashing::hash_long_scalar(data, size, 42));
+    }
+
+    std::vector<std::string_view> keys;
+    for (size_t size = 0; size <= 40; ++size)
+        keys.push_back(std::string_view(long_text).substr(size, size));
+    std::vector<uint64_t> key_hashes(keys.size());
+    hash_batch(keys.begin(), keys.size(), key_hashes.data(), 7);
+    for (size_t i = 0; i < keys.size(); ++i)
+        REQUIRE(key_hashes[i] == fast_hash(keys[i].data(), keys[i].size(), 7));
+
+    REQUIRE(fast_hash("swann", 5) != fast_hash("swann", 5, 1));
+    REQUIRE(fast_hash("swann", 5) != fast_hash("swanN", 5));
+
+    std::string unaligned = "x" + long_text.substr(0, 1000);
+    REQUIRE(fast_hash(unaligned.data() + 1, 1000) == fast_hash(long_text.data(), 1000));
+
+    BENCHMARK("std::hash - long text")
+    {
+        return std::hash<std::string_view>{}(long_text);
+    };
+
+    BENCHMARK("fast hash - long text")
+    {
+        return fast_hash(long_text.data(), long_text.size());
+    };
+}
+
+TEMPLATE_TEST_CASE("accumulate", "", DocumentContent, DocumentView, StringPool)
+{
+    const auto& words = corpus<TestType>();
+
+    auto calc_hash = [](const auto &item) { return std::hash<std::remove_cv_t<std::remove_reference_t<decltype(item)>>>{}(item); };
+    auto calc_fast_hash = [](const auto &item) { return FastHash{}(item); };
+
+    const auto expected_fast_hash = std::accumulate(words.begin(), words.end(), 0ULL, [=](const auto &total, const auto &word) { return total + calc_fast_hash(word); });
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        REQUIRE(sum_of_hashes(policy, words) == expected_fast_hash);
+
+        BENCHMARK("std::hash - " + policy_name(policy))
+        {
+            return ExecutionBackends::transform_reduce(policy, words.begin(), words.end(), 0ULL, std::plus{}, calc_hash);
+        };
+
+        BENCHMARK("fast hash - " + policy_name(policy))
+        {
+            return ExecutionBackends::transform_reduce(policy, words.begin(), words.end(), 0ULL, std::plus{}, calc_fast_hash);
+        };
+
+        BENCHMARK("batch hash - " + policy_name(policy))
+        {
+            return sum_of_hashes(policy, words);
+        };
+    });
+}
+
+TEST_CASE("accumulate - word ids")
+{
+    const auto& words = corpus<DocumentContent>();
+    const auto& words_interned = corpus<InternedDocument>();
+    const auto& ids = words_interned.ids;
+    const auto& symbols = words_interned.symbols;
+    std::cout << "No of distinct words: " << symbols.size() << std::endl;
+
+    auto hash_symbols = [&] {
+        std::vector<size_t> symbol_hashes(symbols.size());
+        for (WordId id = 0; id < symbols.size(); ++id)
+            symbol_hashes[id] = std::hash<std::string_view>{}(symbols.text(id));
+        return symbol_hashes;
+    };
+
+    const auto expected = std::accumulate(words.begin(), words.end(), 0ULL, [](auto total, const auto &word) { return total + std::hash<std::string>{}(word); });
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        const auto symbol_hashes = hash_symbols();
+        REQUIRE(ExecutionBackends::transform_reduce(policy, ids.begin(), ids.end(), 0ULL, std::plus{}, [&](WordId id) { return symbol_hashes[id]; }) == expected);
+
+        BENCHMARK(policy_name(policy))
+        {
+            const auto symbol_hashes = hash_symbols();
+            return ExecutionBackends::transform_reduce(policy, ids.begin(), ids.end(), 0ULL, std::plus{}, [&](WordId id) { return symbol_hashes[id]; });
+        };
+    });
+}
+
+TEST_CASE("word count")
+{
+    const auto& words = corpus<DocumentView>();
+    const auto& words_interned = corpus<InternedDocument>();
+
+    std::vector<size_t> id_counts(words_interned.symbols.size());
+    for (WordId id : words_interned.ids)
+        ++id_counts[id];
+
+    WordCounts expected;
+    for (WordId id = 0; id < id_counts.size(); ++id)
+        expected.emplace(words_interned.symbols.text(id), id_counts[id]);
+
+    const std::vector<std::pair<CountingStrategy, std::string>> strategies = {
+        {CountingStrategy::thread_local_maps, "thread local maps"},
+        {CountingStrategy::sharded_map, "sharded map"},
+        {CountingStrategy::lock_free_table, "lock-free table"},
+        {CountingStrategy::sort_and_count, "sort & count"}};
+
+    ThreadPool oversubscribed_pool{2 * std::max(std::thread::hardware_concurrency(), 2u)};
+    for (const auto& strategy : strategies)
+        REQUIRE(count_words(strategy.first, oversubscribed_pool, words) == expected);
+    REQUIRE(count_ids(oversubscribed_pool, words_interned) == id_counts);
+    REQUIRE(WordCounting::count_lock_free(oversubscribed_pool, words, 1) == expected); // far too small a table is rebuilt
+
+    for (size_t no_of_threads : thread_count_sweep())
+    {
+        ThreadPool pool{no_of_threads};
+
+        for (const auto& strategy : strategies)
+        {
+            REQUIRE(count_words(strategy.first, pool, words) == expected);
+
+            BENCHMARK(strategy.second + " - " + std::to_string(no_of_threads) + " threads")
+            {
+                return count_words(strategy.first, pool, words).size();
+            };
+        }
+
+        REQUIRE(count_ids(pool, words_interned) == id_counts);
+
+        BENCHMARK("interned ids - " + std::to_string(no_of_threads) + " threads")
+        {
+            return count_ids(pool, words_interned).size();
+        };
+    }
+}
+
+template <typename Words>
+size_t total_chars(const Words& words)
+{
+    return std::accumulate(words.begin(), words.end(), size_t{0}, [](size_t total, const auto &word) { return total + std::string_view(word).size(); });
+}
+
+// folds all words back to back into out, which must hold total_chars(words) chars
+template <typename Words>
+size_t fold_words(const Words& words, char* out)
+{
+    char* const begin = out;
+    for (const auto &word : words)
+    {
+        fold_case(word.data(), word.size(), out);
+        out += word.size();
+    }
+    return out - begin;
+}
+
+TEST_CASE("case folding")
+{
+    REQUIRE(fold_case_copy("SWANN'S Way") == "swann's way");
+    REQUIRE(fold_case_copy("ÉCOLE À PARIS, Œuvre, ŸVES") == "école à paris, œuvre, ÿves");
+    REQUIRE(fold_case_copy("ΑΘΗΝΑ МОСКВА Ёж") == "αθηνα москва ёж");
+    REQUIRE(fold_case_copy("× ß € 😀 \xC3") == "× ß € 😀 \xC3"); // no simple lowercase, 3/4-byte and broken sequences
+
+    std::string mixed_blocks;
+    std::string expected;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        mixed_blocks += (i % 7 == 0) ? "É" : "aB";
+        expected += (i % 7 == 0) ? "é" : "ab";
+    }
+    REQUIRE(fold_case_copy(mixed_blocks) == expected);
+    fold_case_inplace(mixed_blocks);
+    REQUIRE(mixed_blocks == expected);
+
+    const auto text = token_text();
+    const auto& words = corpus<DocumentContent>();
+
+    // the words dataset is the file repeated to its size - it may hold more chars than the text
+    const auto& more_words = datasets().get<DocumentContent>("words", 2 * token_source().size() + 1);
+    std::vector<char> more_folded(total_chars(more_words));
+    REQUIRE(more_folded.size() > text.size());
+    REQUIRE(fold_words(more_words, more_folded.data()) == more_folded.size());
+
+    std::string expected_folded;
+    for (const auto &word : more_words)
+        expected_folded += fold_case_copy(word);
+    REQUIRE(std::string_view(more_folded.data(), more_folded.size()) == expected_folded);
+
+    BENCHMARK_ADVANCED("boost::to_lower - text")
     (Catch::Benchmark::Chronometer meter)
     {
-        auto words_to_sort = words;
-        REQUIRE_FALSE(std::is_sorted(words_to_sort.begin(), words_to_sort.end()));
+        measure_on_fresh_copies(meter, std::string(text), [](std::string &buffer) { boost::to_lower(buffer); return buffer.size(); });
+    };
 
-        meter.measure([&] {
-            std::sort(
-                words_to_sort.begin(), words_to_sort.end(),
-                [](const auto &a, const auto &b) { return boost::to_lower_copy(a) < boost::to_lower_copy(b); });
-            return words_to_sort.front();
-        });
+    BENCHMARK_ADVANCED("fold_case_inplace - text")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        measure_on_fresh_copies(meter, std::string(text), [](std::string &buffer) { fold_case_inplace(buffer); return buffer.size(); });
+    };
+
+    BENCHMARK("boost::to_lower_copy - words")
+    {
+        size_t total = 0;
+        for (const auto &word : words)
+            total += boost::to_lower_copy(word).size();
+        return total;
     };
 
-    BENCHMARK_ADVANCED("parallel")
+    BENCHMARK("fold_case_copy - words")
+    {
+        size_t total = 0;
+        for (const auto &word : words)
+            total += fold_case_copy(word).size();
+        return total;
+    };
+
+    BENCHMARK_ADVANCED("fold_case - words to buffer")
     (Catch::Benchmark::Chronometer meter)
     {
-        auto words_to_sort = words;
-        REQUIRE_FALSE(std::is_sorted(words_to_sort.begin(), words_to_sort.end()));
+        std::vector<char> buffer(total_chars(words));
+        meter.measure([&] { return fold_words(words, buffer.data()); });
+    };
+}
+
+TEMPLATE_TEST_CASE("sort", "", DocumentContent, DocumentView, StringPool)
+{
+    const auto& words = corpus<TestType>();
+    using Words = std::vector<typename TestType::value_type>;
+
+    const Words words_to_sort(words.begin(), words.end());
+    REQUIRE_FALSE(std::is_sorted(words_to_sort.begin(), words_to_sort.end()));
+
+    auto case_insensitive_less = [](const auto &a, const auto &b) { return to_lower_copy(a) < to_lower_copy(b); };
+    auto folded_less = [](const auto &a, const auto &b) { return fold_case_copy(a) < fold_case_copy(b); };
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        if constexpr (ExecutionBackends::allows_locking<decltype(policy)>) // to_lower_copy() allocates, allocators may lock
+        {
+            BENCHMARK_ADVANCED(policy_name(policy))
+            (Catch::Benchmark::Chronometer meter)
+            {
+                measure_on_fresh_copies(meter, words_to_sort, [&](Words &words) {
+                    ExecutionBackends::sort(policy, words.begin(), words.end(), case_insensitive_less);
+                    return words.front();
+                });
+            };
+        }
+
+        BENCHMARK_ADVANCED("collation keys - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            const auto sorted = measure_on_fresh_copies(meter, words_to_sort, [&](Words &words) {
+                sort_case_insensitive(policy, words);
+                return words.front();
+            });
 
-        meter.measure([&] {
-            std::sort(
-                std::execution::par,
-                words_to_sort.begin(), words_to_sort.end(),
-                [](const auto &a, const auto &b) { return boost::to_lower_copy(a) < boost::to_lower_copy(b); });
+            REQUIRE(std::is_sorted(sorted.back().begin(), sorted.back().end(), folded_less));
+        };
+    });
+
+    if constexpr (std::is_same_v<TestType, DocumentContent>) // lowering in place needs owned strings
+    {
+        BENCHMARK_ADVANCED("lowered in place - parallel unsequenced")
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, words_to_sort, [](Words &words) {
+                std::for_each(std::execution::par, words.begin(), words.end(), [](auto &w) { boost::to_lower(w); });
+                std::vector<std::string_view> words_views(words.size());
+                std::transform(std::execution::par, words.begin(), words.end(), words_views.begin(), [](const auto &w) { return std::string_view(w); });
+
+                std::sort(
+                    std::execution::par_unseq,
+                    words_views.begin(), words_views.end());
+
+                return std::string(words_views.front());
+            });
+        };
+    }
+}
+
+TEST_CASE("work-stealing merge sort")
+{
+    std::mt19937_64 rnd_gen{42};
+    std::vector<int> numbers(10'000);
+    std::generate(numbers.begin(), numbers.end(), [&] { return static_cast<int>(rnd_gen() % 1000); });
+
+    auto expected = numbers;
+    std::sort(expected.begin(), expected.end(), std::greater{});
+
+    for (size_t no_of_threads : {1, 2, 4})
+    {
+        ThreadPool pool{no_of_threads};
 
-            return words_to_sort.front();
+        for (size_t grain_size : {1, 16, 1000, 100'000})
+        {
+            auto sorted = numbers;
+            parallel_merge_sort(pool, sorted.begin(), sorted.end(), std::greater{}, grain_size);
+            REQUIRE(sorted == expected);
+        }
+    }
+
+    ThreadPool pool{2};
+    TaskGroup group{pool};
+    group.run([] { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+}
+
+TEST_CASE("sort - string views")
+{
+    const auto& words = corpus<DocumentView>();
+    const std::vector<std::string_view> words_views(words.begin(), words.end());
+
+    for (size_t size : {0, 1, 100, 1000, 50'000})
+    {
+        std::vector<std::string_view> sorted;
+        for (size_t i = 0; i < size; ++i)
+            sorted.push_back(words_views[(i * 7919) % words_views.size()]);
+        auto expected = sorted;
+        std::sort(expected.begin(), expected.end());
+
+        for_each_policy(benchmark_pool(), [&](const auto &policy) {
+            auto radix_sorted = sorted;
+            msd_radix_sort(policy, radix_sorted);
+            REQUIRE(radix_sorted == expected);
+
+            auto prefix_sorted = sorted;
+            prefix_key_sort(policy, prefix_sorted);
+            REQUIRE(prefix_sorted == expected);
         });
+    }
+
+    std::vector<std::string_view> zero_padding = {std::string_view("ab\0", 3), "ab", std::string_view("ab\0\0\0\0\0\0\0b", 10), std::string_view("ab\0\0\0\0\0\0\0a", 10)};
+    auto expected_padding = zero_padding;
+    std::sort(expected_padding.begin(), expected_padding.end());
+    prefix_key_sort(std::execution::seq, zero_padding);
+    REQUIRE(zero_padding == expected_padding);
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED(policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, words_views, [&](std::vector<std::string_view> &words) {
+                ExecutionBackends::sort(policy, words.begin(), words.end());
+                return words.front();
+            });
+        };
+
+        BENCHMARK_ADVANCED("msd radix sort - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, words_views, [&](std::vector<std::string_view> &words) {
+                msd_radix_sort(policy, words);
+                return words.front();
+            });
+        };
+
+        BENCHMARK_ADVANCED("prefix keys - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, words_views, [&](std::vector<std::string_view> &words) {
+                prefix_key_sort(policy, words);
+                return words.front();
+            });
+        };
+    });
+}
+
+TEST_CASE("external sort")
+{
+    std::vector<std::string_view> expected(token_source().begin(), token_source().end());
+    std::sort(expected.begin(), expected.end());
+
+    // a run holds at least its chars and the sort buffers, and at most half of the limit
+    const size_t min_total_run_memory = total_chars(expected) + expected.size() * 2 * sizeof(std::string_view);
+
+    for (size_t memory_limit : {64 * 1024, 1 << 20, 1 << 26})
+    {
+        std::ifstream input_file{"tokens.txt", std::ios::binary};
+        TokenStream tokens{input_file};
+
+        ExternalSort external_sort{memory_limit};
+        external_sort.add(tokens);
+        INFO("memory limit: " << memory_limit << ", runs: " << external_sort.no_of_runs() << ", peak run memory: " << external_sort.peak_run_memory());
+
+        REQUIRE(external_sort.peak_run_memory() <= memory_limit / 2);
+        REQUIRE(external_sort.no_of_runs() * (memory_limit / 2) >= min_total_run_memory);
+
+        size_t position = 0;
+        bool all_equal = true;
+        external_sort.merge([&](std::string_view token) { all_equal = all_equal && position < expected.size() && token == expected[position++]; });
+
+        REQUIRE(all_equal);
+        REQUIRE(position == expected.size());
+    }
+
+    {
+        std::ifstream input_file{"tokens.txt", std::ios::binary};
+        TokenStream tokens{input_file};
+
+        ExternalSort external_sort{256 * 1024};
+        external_sort.add(tokens);
+
+        const std::string sorted_file_name = "tokens_sorted.txt";
+        REQUIRE(external_sort.merge_to_file(sorted_file_name));
+
+        const auto sorted = load_words(sorted_file_name).value();
+        REQUIRE(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()));
+        std::filesystem::remove(sorted_file_name);
+    }
+
+    const std::filesystem::path run_directory = "external_sort_runs";
+    std::filesystem::create_directory(run_directory);
+
+    {
+        // sorters sharing a temp directory (e.g. tests running in parallel) keep their runs apart
+        std::ifstream input_file_a{"tokens.txt", std::ios::binary}, input_file_b{"tokens.txt", std::ios::binary};
+        TokenStream tokens_a{input_file_a}, tokens_b{input_file_b};
+
+        ExternalSort external_sort_a{64 * 1024, run_directory}, external_sort_b{64 * 1024, run_directory};
+        external_sort_a.add(tokens_a);
+        external_sort_b.add(tokens_b);
+
+        for (auto* external_sort : {&external_sort_a, &external_sort_b})
+        {
+            size_t position = 0;
+            bool all_equal = true;
+            external_sort->merge([&](std::string_view token) { all_equal = all_equal && position < expected.size() && token == expected[position++]; });
+            REQUIRE((all_equal && position == expected.size()));
+        }
+    }
+    REQUIRE(std::filesystem::is_empty(run_directory)); // the sorters removed their runs
+
+    {
+        std::ifstream input_file{"tokens.txt", std::ios::binary};
+        TokenStream tokens{input_file};
+
+        ExternalSort external_sort{64 * 1024, run_directory};
+        external_sort.add(tokens);
+        REQUIRE(external_sort.no_of_runs() > 1);
+
+        size_t no_of_tokens = 0;
+        external_sort.merge([&](std::string_view) { ++no_of_tokens; });
+        REQUIRE(no_of_tokens == expected.size());
+
+        std::vector<std::filesystem::path> run_files; // runs lost before the merge
+        for (const auto& entry : std::filesystem::recursive_directory_iterator{run_directory})
+            if (entry.is_regular_file())
+                run_files.push_back(entry.path());
+        for (const auto& run_file : run_files)
+            std::filesystem::remove(run_file);
+        REQUIRE_THROWS_AS(external_sort.merge([](std::string_view) {}), std::runtime_error);
+    }
+
+    std::filesystem::remove_all(run_directory);
+
+    BENCHMARK("in memory - std::sort parallel")
+    {
+        auto words = load_words_mapped("tokens.txt").value();
+        std::vector<std::string_view> words_to_sort(words.begin(), words.end());
+        std::sort(std::execution::par, words_to_sort.begin(), words_to_sort.end());
+        return words_to_sort.size();
     };
 
-    BENCHMARK_ADVANCED("parallel unsequenced")
-    (Catch::Benchmark::Chronometer meter)
+    for (size_t memory_limit : {256 * 1024, 4 << 20})
     {
-        auto words_to_sort = words;
-        REQUIRE_FALSE(std::is_sorted(words_to_sort.begin(), words_to_sort.end()));
+        BENCHMARK("external sort - memory limit " + std::to_string(memory_limit / 1024) + " KiB")
+        {
+            std::ifstream input_file{"tokens.txt", std::ios::binary};
+            TokenStream tokens{input_file};
+
+            ExternalSort external_sort{memory_limit};
+            external_sort.add(tokens);
+
+            size_t no_of_tokens = 0;
+            external_sort.merge([&](std::string_view) { ++no_of_tokens; });
+            return no_of_tokens;
+        };
+    }
+}
+
+TEST_CASE("sort - word ids")
+{
+    const auto& words_interned = corpus<InternedDocument>();
+    auto case_insensitive_less = [](const auto &a, const auto &b) { return to_lower_copy(a) < to_lower_copy(b); };
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED(policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            const auto sorted = measure_on_fresh_copies(meter, words_interned.ids, [&](std::vector<WordId> &ids) {
+                const auto ranks = words_interned.symbols.ranks(case_insensitive_less);
+                ExecutionBackends::sort(policy, ids.begin(), ids.end(), [&](WordId a, WordId b) { return ranks[a] < ranks[b]; });
+                return ids.front();
+            });
+
+            REQUIRE(std::is_sorted(sorted.back().begin(), sorted.back().end(),
+                [&](WordId a, WordId b) { return case_insensitive_less(words_interned.symbols.text(a), words_interned.symbols.text(b)); }));
+        };
+    });
+}
 
-        meter.measure([&] {
-            std::for_each(std::execution::par, words_to_sort.begin(), words_to_sort.end(), [](auto &w) { boost::to_lower(w); });
-            std::vector<std::string_view> words_views(words_to_sort.size());
-            std::transform(std::execution::par, words_to_sort.begin(), words_to_sort.end(), words_views.begin(), [](const auto &w) { return std::string_view(w); });
+TEST_CASE("streaming")
+{
+    const auto& words = token_source();
 
-            std::sort(
-                std::execution::par_unseq,
-                words_views.begin(), words_views.end());
+    auto stream_hash = [](TokenStream& tokens) {
+        unsigned long long total = 0;
+        for_each_batch(tokens, [&](const auto &batch) {
+            total += std::transform_reduce(std::execution::par, batch.begin(), batch.end(), 0ULL, std::plus{}, std::hash<std::string_view>{});
+        });
+        return total;
+    };
+
+    auto stream_count = [](TokenStream& tokens) {
+        std::unordered_map<std::string, size_t> frequencies;
+        for_each_batch(tokens, [&](const auto &batch) {
+            for (const auto &token : batch)
+                ++frequencies[std::string(token)];
+        });
+        return frequencies;
+    };
 
-            return std::string(words_views.front());
+    auto stream_sorted_runs = [](TokenStream& tokens) {
+        size_t no_of_runs = 0;
+        std::vector<std::string_view> run;
+        for_each_batch(tokens, [&](const auto &batch) {
+            run.assign(batch.begin(), batch.end());
+            std::sort(std::execution::par, run.begin(), run.end());
+            ++no_of_runs;
         });
+        return no_of_runs;
     };
+
+    SECTION("tokens match the loaded document")
+    {
+        const auto expected_hash = std::transform_reduce(words.begin(), words.end(), 0ULL, std::plus{}, std::hash<std::string_view>{});
+
+        for (size_t memory_limit : {64, 4096, 1 << 20})
+        {
+            std::ifstream input_file{"tokens.txt", std::ios::binary};
+            TokenStream tokens{input_file, memory_limit};
+            REQUIRE(stream_hash(tokens) == expected_hash);
+        }
+
+        {
+            std::ifstream input_file{"tokens.txt", std::ios::binary};
+            TokenStream tokens{input_file, 8}; // a 7 char buffer grows for longer tokens
+            std::vector<std::string> streamed;
+            for_each_batch(tokens, [&](const auto &batch) { streamed.insert(streamed.end(), batch.begin(), batch.end()); });
+            REQUIRE(std::equal(streamed.begin(), streamed.end(), words.begin(), words.end()));
+        }
+
+        {
+            const std::string long_token(10'000, 'x');
+            std::istringstream input{"a " + long_token + " b " + long_token};
+            TokenStream tokens{input, 64};
+            std::vector<std::string> streamed;
+            for_each_batch(tokens, [&](const auto &batch) { streamed.insert(streamed.end(), batch.begin(), batch.end()); });
+            REQUIRE(streamed == std::vector<std::string>{"a", long_token, "b", long_token});
+        }
+
+        std::ifstream input_file{"tokens.txt", std::ios::binary};
+        TokenStream tokens{input_file};
+        REQUIRE(stream_count(tokens).at("Swann") == static_cast<size_t>(std::count(words.begin(), words.end(), "Swann")));
+    }
+
+    SECTION("benchmarks")
+    {
+        BENCHMARK("hash")
+        {
+            std::ifstream input_file{"tokens.txt", std::ios::binary};
+            TokenStream tokens{input_file};
+            return stream_hash(tokens);
+        };
+
+        BENCHMARK("count")
+        {
+            std::ifstream input_file{"tokens.txt", std::ios::binary};
+            TokenStream tokens{input_file};
+            return stream_count(tokens).size();
+        };
+
+        BENCHMARK("sort batches")
+        {
+            std::ifstream input_file{"tokens.txt", std::ios::binary};
+            TokenStream tokens{input_file};
+            return stream_sorted_runs(tokens);
+        };
+    }
 }
 
 bool is_prime(uint64_t number)
@@ -132,65 +993,411 @@ bool is_prime(uint64_t number)
     }
 }
 
-const size_t no_of_items = 20'000;
+TEST_CASE("prime sieve")
+{
+    for (uint64_t limit : {0, 1, 2, 3, 64, 127, 128, 129, 100'000, 600'000})
+    {
+        const PrimeSieve sieve{std::execution::seq, limit};
+
+        size_t no_of_mismatches = 0;
+        for (uint64_t n = 0; n <= limit; ++n)
+            no_of_mismatches += sieve.is_prime(n) != is_prime(n);
 
-const std::vector<uint64_t> numbers = [] {
-    std::random_device rd;
-    std::mt19937_64 rnd_gen{rd()};
-    std::uniform_int_distribution<uint64_t> rnd_distr(0, no_of_items);
+        for_each_policy(benchmark_pool(), [&](const auto &policy) {
+            const PrimeSieve policy_sieve{policy, limit};
+            for (uint64_t n = 0; n <= limit; ++n)
+                no_of_mismatches += policy_sieve.is_prime(n) != sieve.is_prime(n);
+        });
+        REQUIRE(no_of_mismatches == 0);
+    }
 
-    std::vector<uint64_t> numbers(no_of_items);
-    std::generate(numbers.begin(), numbers.end(), [&] { return rnd_distr(rnd_gen); });
+    REQUIRE_THROWS_AS(PrimeSieve(std::execution::seq, 100).is_prime(101), std::out_of_range);
 
-    return numbers;
-}();
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers");
+    REQUIRE(sieve_for(std::execution::par, numbers).limit() == *std::max_element(numbers.begin(), numbers.end()));
+}
 
-TEST_CASE("transform")
+TEST_CASE("miller-rabin")
 {
-    BENCHMARK_ADVANCED("sequenced")
-    (Catch::Benchmark::Chronometer meter)
-    {
-        auto numbers_to_part = numbers;
-        decltype(numbers_to_part) are_primes(numbers_to_part.size());
+    size_t no_of_mismatches = 0;
+    for (uint64_t n = 0; n <= 100'000; ++n)
+        no_of_mismatches += is_prime_miller_rabin(n) != is_prime(n);
+    REQUIRE(no_of_mismatches == 0);
 
-        meter.measure([&] {
-            std::transform(numbers_to_part.begin(), numbers_to_part.end(), are_primes.begin(), [](auto n) { return is_prime(n); });
-            return are_primes;
-        });
+    for (uint64_t prime : {2'147'483'647ull, 1'000'000'007ull, (1ull << 61) - 1, 18'446'744'073'709'551'557ull /* 2^64 - 59 */})
+        REQUIRE(is_prime_miller_rabin(prime));
+
+    // Carmichael numbers, strong pseudoprimes to the first prime bases and products of large primes
+    for (uint64_t composite : {561ull, 2047ull, 3'215'031'751ull, 3'825'123'056'546'413'051ull,
+             1'000'000'007ull * 998'244'353ull, 4'294'967'291ull * 4'294'967'279ull, 18'446'744'073'709'551'615ull})
+        REQUIRE_FALSE(is_prime_miller_rabin(composite));
+
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers_full_range");
+    std::vector<uint8_t> expected(numbers.size());
+    are_primes(std::execution::seq, numbers.begin(), numbers.end(), expected.begin());
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        std::vector<uint8_t> results(numbers.size());
+        are_primes(policy, numbers.begin(), numbers.end(), results.begin());
+        REQUIRE(results == expected);
+    });
+}
+
+TEST_CASE("batched trial division")
+{
+    std::vector<uint64_t> numbers(100'001);
+    std::iota(numbers.begin(), numbers.end(), 0);
+
+    const auto& numbers_full_range = datasets().get<std::vector<uint64_t>>("numbers_full_range");
+    numbers.insert(numbers.end(), numbers_full_range.begin(), numbers_full_range.end());
+    for (uint64_t n : {4'294'967'291ull, 4'294'967'295ull, 4'294'967'311ull, 66'049ull, 66'047ull, 65'521ull * 65'521ull})
+        numbers.insert(numbers.end(), {n, n, n, n, n, n, n, 3}); // full lane groups of large values and a tail
+
+    std::vector<uint8_t> expected(numbers.size());
+    std::transform(numbers.begin(), numbers.end(), expected.begin(), [](auto n) { return is_prime_miller_rabin(n); });
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        std::vector<uint8_t> results(numbers.size());
+        are_primes_trial_division(policy, numbers.begin(), numbers.end(), results.begin());
+        REQUIRE(results == expected);
+
+        auto partitioned = numbers;
+        const auto boundary = partition_primes(policy, partitioned.begin(), partitioned.end());
+        REQUIRE(boundary - partitioned.begin() == std::count(expected.begin(), expected.end(), 1));
+        REQUIRE(std::all_of(partitioned.begin(), boundary, [](auto n) { return is_prime_miller_rabin(n); }));
+        REQUIRE(std::none_of(boundary, partitioned.end(), [](auto n) { return is_prime_miller_rabin(n); }));
+    });
+}
+
+TEST_CASE("factorization")
+{
+    const SmallestFactorTable table{1 << 20};
+
+    auto is_factorization_of = [](uint64_t n, const std::vector<uint64_t>& factors) {
+        uint64_t product = 1;
+        for (uint64_t factor : factors)
+            product *= factor;
+
+        return std::is_sorted(factors.begin(), factors.end()) && (n < 2 ? factors.empty() : product == n) &&
+            std::all_of(factors.begin(), factors.end(), [](auto factor) { return is_prime_miller_rabin(factor); });
     };
 
-    BENCHMARK_ADVANCED("parallel")
-    (Catch::Benchmark::Chronometer meter)
+    size_t no_of_wrong = 0;
+    for (uint64_t n = 0; n <= 100'000; ++n)
+        no_of_wrong += !is_factorization_of(n, factorize(n, SmallestFactorTable{1000})) + !is_factorization_of(n, factorize(n, table));
+    REQUIRE(no_of_wrong == 0);
+
+    REQUIRE(factorize(18'446'744'073'709'551'615ull, table) == std::vector<uint64_t>{3, 5, 17, 257, 641, 65'537, 6'700'417});
+    REQUIRE(factorize(1'000'000'007ull * 998'244'353ull, table) == std::vector<uint64_t>{998'244'353, 1'000'000'007});
+    REQUIRE(factorize(4'294'967'291ull * 4'294'967'291ull, table) == std::vector<uint64_t>{4'294'967'291, 4'294'967'291});
+    REQUIRE(factorize(4'294'967'291ull * 4'294'967'279ull, table) == std::vector<uint64_t>{4'294'967'279, 4'294'967'291});
+    REQUIRE(factorize(18'446'744'073'709'551'557ull, table) == std::vector<uint64_t>{18'446'744'073'709'551'557ull});
+    REQUIRE(factorize(3'825'123'056'546'413'051ull, table) == std::vector<uint64_t>{149'491, 747'451, 34'233'211});
+
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers");
+    const auto& numbers_full_range = datasets().get<std::vector<uint64_t>>("numbers_full_range");
+
+    for (const auto* input : {&numbers, &numbers_full_range})
     {
-        auto numbers_to_part = numbers;
-        decltype(numbers_to_part) are_primes(numbers_to_part.size());
+        std::vector<std::vector<uint64_t>> expected(input->size());
+        factorize_all(std::execution::seq, input->begin(), input->end(), expected.begin(), table);
 
-        meter.measure([&] {
-            std::transform(std::execution::par_unseq, numbers_to_part.begin(), numbers_to_part.end(), are_primes.begin(), [](auto n) { return is_prime(n); });
-            return are_primes;
+        no_of_wrong = 0;
+        for (size_t i = 0; i < input->size(); ++i)
+            no_of_wrong += !is_factorization_of((*input)[i], expected[i]);
+        REQUIRE(no_of_wrong == 0);
+
+        for_each_policy(benchmark_pool(), [&](const auto &policy) {
+            std::vector<std::vector<uint64_t>> factorizations(input->size());
+            factorize_all(policy, input->begin(), input->end(), factorizations.begin(), table);
+            REQUIRE(factorizations == expected);
         });
+    }
+
+    BENCHMARK("smallest factor table")
+    {
+        return SmallestFactorTable{1 << 20}.limit();
     };
+
+    // large semiprimes take Pollard-Brent tens of microseconds - a smaller batch keeps the benchmark run short
+    const auto& numbers_large = datasets().get<std::vector<uint64_t>>("numbers_full_range", 1'000);
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED(policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::vector<uint64_t>> factorizations(numbers.size());
+
+            meter.measure([&] {
+                factorize_all(policy, numbers.begin(), numbers.end(), factorizations.begin(), table);
+                return factorizations.front().size();
+            });
+        };
+
+        BENCHMARK_ADVANCED("full range - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::vector<uint64_t>> factorizations(numbers_large.size());
+
+            meter.measure([&] {
+                factorize_all(policy, numbers_large.begin(), numbers_large.end(), factorizations.begin(), table);
+                return factorizations.front().size();
+            });
+        };
+    });
+}
+
+TEST_CASE("memoization")
+{
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers");
+    const uint64_t limit = *std::max_element(numbers.begin(), numbers.end());
+
+    std::vector<uint64_t> inputs = numbers; // a few values above the dense range are evaluated uncached
+    inputs.insert(inputs.end(), {limit + 1, limit + 2, 2'147'483'647ull, 2'147'483'647ull});
+
+    std::vector<uint8_t> expected(inputs.size());
+    std::transform(inputs.begin(), inputs.end(), expected.begin(), [](auto n) { return is_prime(n); });
+
+    auto distinct = inputs;
+    std::sort(distinct.begin(), distinct.end());
+    const size_t no_of_distinct = std::unique(distinct.begin(), distinct.end()) - distinct.begin();
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        auto dense = memoize_dense([](uint64_t n) { return is_prime(n); }, limit);
+        std::vector<uint8_t> results(inputs.size());
+        ExecutionBackends::transform(policy, inputs.begin(), inputs.end(), results.begin(), [&](auto n) { return dense(n); });
+        REQUIRE(results == expected);
+        REQUIRE(dense.stats().hits + dense.stats().misses == inputs.size());
+        REQUIRE(dense.stats().misses >= no_of_distinct);
+
+        if constexpr (ExecutionBackends::allows_locking<decltype(policy)>)
+        {
+            auto sharded = memoize_sharded<uint64_t>([](uint64_t n) { return is_prime(n); });
+            std::fill(results.begin(), results.end(), 0);
+            ExecutionBackends::transform(policy, inputs.begin(), inputs.end(), results.begin(), [&](auto n) { return sharded(n); });
+            REQUIRE(results == expected);
+            REQUIRE(sharded.stats().hits + sharded.stats().misses == inputs.size());
+            REQUIRE(sharded.stats().misses >= no_of_distinct); // racing threads may both miss
+        }
+    });
+}
+
+TEST_CASE("transform")
+{
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers");
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED(policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> flags(numbers.size());
+
+            meter.measure([&] {
+                ExecutionBackends::transform(policy, numbers.begin(), numbers.end(), flags.begin(), [](auto n) { return is_prime(n); });
+                return flags.front();
+            });
+        };
+    });
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED("miller-rabin - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> are_primes_results(numbers.size());
+
+            meter.measure([&] {
+                are_primes(policy, numbers.begin(), numbers.end(), are_primes_results.begin());
+                return are_primes_results.front();
+            });
+        };
+    });
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED("batched trial division - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> are_primes_results(numbers.size());
+
+            meter.measure([&] {
+                are_primes_trial_division(policy, numbers.begin(), numbers.end(), are_primes_results.begin());
+                return are_primes_results.front();
+            });
+        };
+    });
+
+    // a fresh cache per run: hits come only from duplicates within the batch
+    const uint64_t limit = *std::max_element(numbers.begin(), numbers.end());
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        std::optional<MemoStats> stats;
+
+        BENCHMARK_ADVANCED("memoized dense - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> flags(numbers.size());
+
+            meter.measure([&] {
+                auto memo = memoize_dense([](uint64_t n) { return is_prime(n); }, limit);
+                ExecutionBackends::transform(policy, numbers.begin(), numbers.end(), flags.begin(), [&](auto n) { return memo(n); });
+                stats = memo.stats();
+                return flags.front();
+            });
+        };
+
+        if (stats)
+            std::cout << "memoized dense - " << policy_name(policy) << " - hit rate: " << stats->hit_rate() << std::endl;
+
+        stats.reset();
+
+        if constexpr (ExecutionBackends::allows_locking<decltype(policy)>)
+        {
+            BENCHMARK_ADVANCED("memoized sharded - " + policy_name(policy))
+            (Catch::Benchmark::Chronometer meter)
+            {
+                std::vector<uint64_t> flags(numbers.size());
+
+                meter.measure([&] {
+                    auto memo = memoize_sharded<uint64_t>([](uint64_t n) { return is_prime(n); });
+                    ExecutionBackends::transform(policy, numbers.begin(), numbers.end(), flags.begin(), [&](auto n) { return memo(n); });
+                    stats = memo.stats();
+                    return flags.front();
+                });
+            };
+
+            if (stats)
+                std::cout << "memoized sharded - " << policy_name(policy) << " - hit rate: " << stats->hit_rate() << std::endl;
+        }
+    });
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED("prime sieve - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> flags(numbers.size());
+
+            meter.measure([&] {
+                const auto sieve = sieve_for(policy, numbers);
+                ExecutionBackends::transform(policy, numbers.begin(), numbers.end(), flags.begin(), [&](auto n) { return sieve.is_prime(n); });
+                return flags.front();
+            });
+        };
+    });
 }
 
 TEST_CASE("partition")
 {
-    BENCHMARK_ADVANCED("sequenced")
-    (Catch::Benchmark::Chronometer meter)
-    {
-        auto numbers_to_part = numbers;
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers");
+    const auto no_of_primes = std::count_if(numbers.begin(), numbers.end(), [](auto n) { return is_prime(n); });
+    const uint64_t limit = *std::max_element(numbers.begin(), numbers.end());
 
-        meter.measure([&] {
-            return std::partition(numbers_to_part.begin(), numbers_to_part.end(), [](auto n) { return is_prime(n); });
-        });
-    };
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        auto partitioned = numbers;
+        const auto boundary = ExecutionBackends::partition(policy, partitioned.begin(), partitioned.end(), [](auto n) { return is_prime(n); });
+        REQUIRE(boundary - partitioned.begin() == no_of_primes);
+        REQUIRE(std::is_partitioned(partitioned.begin(), partitioned.end(), [](auto n) { return is_prime(n); }));
 
-    BENCHMARK_ADVANCED("parallel unsequencedszkol")
-    (Catch::Benchmark::Chronometer meter)
-    {
-        auto numbers_to_part = numbers;
+        BENCHMARK_ADVANCED(policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, numbers, [&](std::vector<uint64_t> &numbers_to_part) {
+                return ExecutionBackends::partition(policy, numbers_to_part.begin(), numbers_to_part.end(), [](auto n) { return is_prime(n); }) - numbers_to_part.begin();
+            });
+        };
+
+        std::optional<MemoStats> stats;
 
-        meter.measure([&] {
-            return std::partition(std::execution::par_unseq, numbers_to_part.begin(), numbers_to_part.end(), [](auto n) { return is_prime(n); });
+        BENCHMARK_ADVANCED("memoized dense - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, numbers, [&](std::vector<uint64_t> &numbers_to_part) {
+                auto memo = memoize_dense([](uint64_t n) { return is_prime(n); }, limit);
+                const auto boundary = ExecutionBackends::partition(policy, numbers_to_part.begin(), numbers_to_part.end(), [&](auto n) { return memo(n); });
+                stats = memo.stats();
+                return boundary - numbers_to_part.begin();
+            });
+        };
+
+        if (stats)
+            std::cout << "memoized dense - " << policy_name(policy) << " - hit rate: " << stats->hit_rate() << std::endl;
+
+        BENCHMARK_ADVANCED("batched trial division - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            measure_on_fresh_copies(meter, numbers, [&](std::vector<uint64_t> &numbers_to_part) {
+                return partition_primes(policy, numbers_to_part.begin(), numbers_to_part.end()) - numbers_to_part.begin();
+            });
+        };
+    });
+}
+
+TEST_CASE("transform - full range")
+{
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers_full_range");
+
+    for_each_policy(benchmark_pool(), [&](const auto &policy) {
+        BENCHMARK_ADVANCED("miller-rabin - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> are_primes_results(numbers.size());
+
+            meter.measure([&] {
+                are_primes(policy, numbers.begin(), numbers.end(), are_primes_results.begin());
+                return are_primes_results.front();
+            });
+        };
+
+        BENCHMARK_ADVANCED("batched trial division - " + policy_name(policy))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<uint64_t> are_primes_results(numbers.size());
+
+            meter.measure([&] {
+                are_primes_trial_division(policy, numbers.begin(), numbers.end(), are_primes_results.begin());
+                return are_primes_results.front();
+            });
+        };
+    });
+}
+
+// run with: benchmarks-algorithms [scaling]
+TEST_CASE("scaling", "[.scaling]")
+{
+    const auto& words = corpus<DocumentView>();
+    const auto& numbers = datasets().get<std::vector<uint64_t>>("numbers");
+    const auto thread_counts = thread_count_sweep();
+
+    // arenas, inputs and outputs are prepared outside of the timed kernels - serial setup would inflate the serial fraction
+    ThreadArenas arenas{thread_counts};
+
+    print_scaling(std::cout, "fast hash - std::transform_reduce parallel", measure_scaling([&](size_t no_of_threads) {
+        return arenas.run(no_of_threads, [&] { return sum_of_hashes(std::execution::par, words); });
+    }, thread_counts));
+
+    std::vector<uint8_t> flags(numbers.size());
+    print_scaling(std::cout, "is_prime - std::transform parallel", measure_scaling([&](size_t no_of_threads) {
+        arenas.run(no_of_threads, [&] {
+            std::transform(std::execution::par, numbers.begin(), numbers.end(), flags.begin(), [](auto n) { return is_prime(n); });
         });
+    }, thread_counts));
+
+    auto words_to_sort = [&] { return std::vector<std::string_view>(words.begin(), words.end()); };
+
+    print_scaling(std::cout, "msd radix sort - parallel", measure_scaling(words_to_sort, [&](size_t no_of_threads, std::vector<std::string_view> &words_copy) {
+        arenas.run(no_of_threads, [&] { msd_radix_sort(std::execution::par, words_copy); });
+    }, thread_counts));
+
+    std::vector<std::unique_ptr<ThreadPool>> pools; // pools are built outside of the measurements
+    for (size_t no_of_threads : thread_counts)
+        pools.push_back(std::make_unique<ThreadPool>(no_of_threads));
+    auto pool_of = [&](size_t no_of_threads) -> ThreadPool& {
+        return *pools[std::find(thread_counts.begin(), thread_counts.end(), no_of_threads) - thread_counts.begin()];
     };
-}
\ No newline at end of file
+
+    print_scaling(std::cout, "work-stealing merge sort", measure_scaling(words_to_sort, [&](size_t no_of_threads, std::vector<std::string_view> &words_copy) {
+        parallel_merge_sort(pool_of(no_of_threads), words_copy.begin(), words_copy.end());
+    }, thread_counts));
+
+    print_scaling(std::cout, "word count - lock-free table", measure_scaling([&](size_t no_of_threads) {
+        return count_words(CountingStrategy::lock_free_table, pool_of(no_of_threads), words).size();
+    }, thread_counts));
+}
@@ -0,0 +1,191 @@
+#ifndef BINARY_CORPUS_HPP
+#define BINARY_CORPUS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "corpus.hpp"
+#include "index_iterator.hpp"
+
+// Layout of a binary corpus file:
+//   CorpusHeader
+//   uint64_t offsets[no_of_tokens + 1] - token i spans chars [offsets[i], offsets[i + 1])
+//   char chars[no_of_chars]            - all tokens back to back, no separators
+struct CorpusHeader
+{
+    static constexpr char signature[8] = {'T', 'O', 'K', 'E', 'N', 'S', '\0', '\0'};
+    static constexpr uint32_t current_version = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t no_of_tokens;
+    uint64_t no_of_chars;
+};
+
+static_assert(sizeof(CorpusHeader) == 32);
+
+template <typename Document>
+bool write_corpus(const std::string& file_name, const Document& tokens)
+{
+    std::ofstream output_file{file_name, std::ios::binary};
+
+    if (!output_file)
+        return false;
+
+    std::vector<uint64_t> offsets;
+    offsets.reserve(tokens.size() + 1);
+    offsets.push_back(0);
+
+    for (const auto& token : tokens)
+        offsets.push_back(offsets.back() + std::string_view(token).size());
+
+    CorpusHeader header{};
+    std::memcpy(header.magic, CorpusHeader::signature, sizeof(header.magic));
+    header.version = CorpusHeader::current_version;
+    header.no_of_tokens = tokens.size();
+    header.no_of_chars = offsets.back();
+
+    output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output_file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    for (const auto& token : tokens)
+    {
+        std::string_view chars{token};
+        output_file.write(chars.data(), chars.size());
+    }
+
+    return static_cast<bool>(output_file);
+}
+
+// Memory-mapped binary corpus - usable right after open(), tokens are never parsed or copied
+class BinaryCorpus
+{
+    MappedFile file_;
+    const uint64_t* offsets_ = nullptr;
+    const char* chars_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    using value_type = std::string_view;
+    using const_iterator = IndexIterator<BinaryCorpus>;
+    using iterator = const_iterator;
+
+    // std::nullopt if the file cannot be opened; throws std::runtime_error if it is not a valid corpus
+    // (every offset is checked, so a corrupt or truncated file is never read out of bounds)
+    static std::optional<BinaryCorpus> open(const std::string& file_name)
+    {
+        auto file = MappedFile::open(file_name);
+
+        if (!file)
+            return std::nullopt;
+
+        auto invalid = [&](const std::string& reason) { return std::runtime_error("Invalid binary corpus " + file_name + ": " + reason); };
+
+        const std::string_view content = file->content();
+        CorpusHeader header;
+
+        if (content.size() < sizeof(header))
+            throw invalid("file too short for the header");
+
+        std::memcpy(&header, content.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, CorpusHeader::signature, sizeof(header.magic)) != 0)
+            throw invalid("wrong signature");
+
+        if (header.version != CorpusHeader::current_version)
+            throw invalid("unsupported version " + std::to_string(header.version));
+
+        const uint64_t body_size = content.size() - sizeof(header);
+
+        if (header.no_of_tokens >= body_size / sizeof(uint64_t)) // no room for no_of_tokens + 1 offsets (also keeps the size below from overflowing)
+            throw invalid("file too short for the offsets");
+
+        const uint64_t offsets_size = (header.no_of_tokens + 1) * sizeof(uint64_t);
+
+        if (header.no_of_chars != body_size - offsets_size)
+            throw invalid("size does not match the header");
+
+        BinaryCorpus corpus;
+        corpus.offsets_ = reinterpret_cast<const uint64_t*>(content.data() + sizeof(header)); // the mapping is page aligned
+        corpus.chars_ = content.data() + sizeof(header) + offsets_size;
+        corpus.size_ = header.no_of_tokens;
+
+        if (corpus.offsets_[0] != 0)
+            throw invalid("first offset is not 0");
+
+        for (size_t i = 0; i < corpus.size_; ++i)
+            if (corpus.offsets_[i] > corpus.offsets_[i + 1])
+                throw invalid("decreasing offsets");
+
+        if (corpus.offsets_[corpus.size_] > header.no_of_chars)
+            throw invalid("offsets past the characters");
+
+        corpus.file_ = std::move(*file);
+
+        return corpus;
+    }
+
+    std::string_view operator[](size_t index) const
+    {
+        return {chars_ + offsets_[index], static_cast<size_t>(offsets_[index + 1] - offsets_[index])};
+    }
+
+    std::string_view front() const { return (*this)[0]; }
+    std::string_view back() const { return (*this)[size_ - 1]; }
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // hands the mapping over to a DocumentView of the given tokens, which must be views into this corpus
+    DocumentView into_view(std::vector<std::string_view> tokens) &&
+    {
+        return DocumentView{std::move(file_), std::move(tokens)};
+    }
+};
+
+// Binary corpus of a text file: binary_file_name is opened if it is not older than the text,
+// otherwise (missing or stale) the text is parsed once and the binary file is rebuilt from it
+inline BinaryCorpus open_corpus(const std::string& text_file_name, const std::string& binary_file_name)
+{
+    std::error_code text_error, binary_error;
+    const auto text_time = std::filesystem::last_write_time(text_file_name, text_error);
+    const auto binary_time = std::filesystem::last_write_time(binary_file_name, binary_error);
+
+    if (!binary_error && (text_error || binary_time >= text_time))
+    {
+        if (auto corpus = BinaryCorpus::open(binary_file_name))
+            return std::move(*corpus);
+    }
+
+    const auto words = load_words_mapped(text_file_name);
+
+    if (!words)
+        throw std::runtime_error("Cannot read " + text_file_name);
+
+    // written under a unique name and renamed, so a concurrent reader never maps a half-written file
+    const std::string temp_file_name = binary_file_name + "." + std::to_string(std::random_device{}()) + ".tmp";
+
+    if (!write_corpus(temp_file_name, *words))
+    {
+        std::filesystem::remove(temp_file_name, binary_error);
+        throw std::runtime_error("Cannot write " + binary_file_name);
+    }
+
+    std::filesystem::rename(temp_file_name, binary_file_name);
+
+    return BinaryCorpus::open(binary_file_name).value();
+}
+
+#endif
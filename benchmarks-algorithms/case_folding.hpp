@@ -0,0 +1,181 @@
+#ifndef CASE_FOLDING_HPP
+#define CASE_FOLDING_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "separators.hpp"
+
+// Simple (length preserving) UTF-8 case folding:
+//   - ASCII letters are lowered 16/32 bytes at a time,
+//   - two-byte sequences (U+0080 - U+07FF: Latin-1, Latin Extended-A, Greek, Cyrillic) go through a lookup table,
+//   - longer sequences and malformed bytes are copied unchanged.
+namespace CaseFolding
+{
+    constexpr std::array<uint16_t, 0x800> make_two_byte_table()
+    {
+        std::array<uint16_t, 0x800> table{};
+
+        for (uint16_t cp = 0; cp < table.size(); ++cp)
+            table[cp] = cp;
+
+        for (uint16_t cp = 0xC0; cp <= 0xDE; ++cp) // Latin-1: À-Þ except ×
+            if (cp != 0xD7)
+                table[cp] = cp + 0x20;
+
+        for (uint16_t cp = 0x100; cp <= 0x17F; ++cp) // Latin Extended-A: upper/lower pairs
+        {
+            const bool even_pairs = cp < 0x138 || (cp >= 0x14A && cp < 0x178);
+            const bool odd_pairs = (cp >= 0x139 && cp < 0x149) || (cp >= 0x179 && cp < 0x17F);
+
+            if ((even_pairs && cp % 2 == 0 && cp != 0x130) || (odd_pairs && cp % 2 == 1))
+                table[cp] = cp + 1;
+        }
+        table[0x178] = 0xFF; // Ÿ -> ÿ
+
+        for (uint16_t cp = 0x391; cp <= 0x3AB; ++cp) // Greek: Α-Ϋ
+            if (cp != 0x3A2)
+                table[cp] = cp + 0x20;
+
+        for (uint16_t cp = 0x400; cp <= 0x40F; ++cp) // Cyrillic: Ѐ-Џ
+            table[cp] = cp + 0x50;
+
+        for (uint16_t cp = 0x410; cp <= 0x42F; ++cp) // Cyrillic: А-Я
+            table[cp] = cp + 0x20;
+
+        return table;
+    }
+
+    inline constexpr std::array<uint16_t, 0x800> two_byte_lower = make_two_byte_table();
+
+    constexpr char ascii_lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    // folds the two-byte sequence at in[pos] if there is one; returns the number of bytes handled
+    inline size_t fold_sequence(const char* in, size_t pos, size_t size, char* out)
+    {
+        const auto lead = static_cast<unsigned char>(in[pos]);
+
+        if ((lead & 0xE0) == 0xC0 && pos + 1 < size && (static_cast<unsigned char>(in[pos + 1]) & 0xC0) == 0x80)
+        {
+            const uint16_t cp = ((lead & 0x1F) << 6) | (static_cast<unsigned char>(in[pos + 1]) & 0x3F);
+            const uint16_t lower = two_byte_lower[cp];
+
+            out[pos] = static_cast<char>(0xC0 | (lower >> 6));
+            out[pos + 1] = static_cast<char>(0x80 | (lower & 0x3F));
+            return 2;
+        }
+
+        out[pos] = in[pos];
+        return 1;
+    }
+
+#if defined(__AVX2__)
+    constexpr size_t block_size = 32;
+
+    // lowers ASCII letters of the block (other bytes are left as they are); returns the mask of non-ASCII bytes
+    inline uint64_t fold_ascii_block(const char* in, char* out)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+        const __m256i is_upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes)); // bytes >= 0x80 are negative - never in range
+        const __m256i lowered = _mm256_add_epi8(bytes, _mm256_and_si256(is_upper, _mm256_set1_epi8('a' - 'A')));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lowered);
+
+        return static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    constexpr size_t block_size = 16;
+
+    inline uint64_t fold_ascii_block(const char* in, char* out)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        const __m128i is_upper = _mm_and_si128(
+            _mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)),
+            _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), bytes));
+        const __m128i lowered = _mm_add_epi8(bytes, _mm_and_si128(is_upper, _mm_set1_epi8('a' - 'A')));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lowered);
+
+        return static_cast<uint16_t>(_mm_movemask_epi8(bytes));
+    }
+#else
+    constexpr size_t block_size = 8;
+
+    inline uint64_t fold_ascii_block(const char* in, char* out)
+    {
+        uint64_t non_ascii_mask = 0;
+
+        for (size_t i = 0; i < block_size; ++i)
+        {
+            non_ascii_mask |= static_cast<uint64_t>(static_cast<unsigned char>(in[i]) >> 7) << i;
+            out[i] = ascii_lower(in[i]);
+        }
+
+        return non_ascii_mask;
+    }
+#endif
+}
+
+// Folds size bytes from in to out (in == out is allowed); the output always has the same length as the input
+inline void fold_case(const char* in, size_t size, char* out)
+{
+    using namespace CaseFolding;
+
+    size_t pos = 0;
+
+    while (pos + block_size <= size)
+    {
+        const char* block = in + pos;
+        uint64_t non_ascii_mask = fold_ascii_block(block, out + pos);
+        size_t next_pos = pos + block_size;
+
+        for (size_t skip_until = pos; non_ascii_mask != 0; non_ascii_mask &= non_ascii_mask - 1)
+        {
+            const size_t sequence_pos = pos + count_trailing_zeros(non_ascii_mask);
+
+            if (sequence_pos >= skip_until)
+                skip_until = sequence_pos + fold_sequence(in, sequence_pos, size, out);
+
+            next_pos = std::max(next_pos, skip_until); // a sequence may end in the next block
+        }
+
+        pos = next_pos;
+    }
+
+    while (pos < size)
+    {
+        if (static_cast<unsigned char>(in[pos]) < 0x80)
+        {
+            out[pos] = ascii_lower(in[pos]);
+            ++pos;
+        }
+        else
+        {
+            pos += fold_sequence(in, pos, size, out);
+        }
+    }
+}
+
+inline void fold_case_inplace(std::string& text)
+{
+    fold_case(text.data(), text.size(), text.data());
+}
+
+inline std::string fold_case_copy(std::string_view text)
+{
+    std::string folded(text.size(), '\0');
+    fold_case(text.data(), text.size(), folded.data());
+    return folded;
+}
+
+#endif
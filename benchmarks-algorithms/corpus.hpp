@@ -0,0 +1,173 @@
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "tokenizer.hpp"
+
+// Read-only view of the whole file - the content stays valid (and does not move) as long as the object lives
+class MappedFile
+{
+#if defined(_WIN32)
+    std::vector<char> buffer_;
+#else
+    void* address_ = nullptr;
+    size_t size_ = 0;
+#endif
+
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+    {
+        swap(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        MappedFile temp{std::move(other)};
+        swap(temp);
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+#if !defined(_WIN32)
+        if (address_)
+            ::munmap(address_, size_);
+#endif
+    }
+
+    void swap(MappedFile& other) noexcept
+    {
+#if defined(_WIN32)
+        buffer_.swap(other.buffer_);
+#else
+        std::swap(address_, other.address_);
+        std::swap(size_, other.size_);
+#endif
+    }
+
+    std::string_view content() const
+    {
+#if defined(_WIN32)
+        return {buffer_.data(), buffer_.size()};
+#else
+        return {static_cast<const char*>(address_), size_};
+#endif
+    }
+
+    static std::optional<MappedFile> open(const std::string& file_name)
+    {
+        MappedFile file;
+
+#if defined(_WIN32)
+        std::ifstream input_file{file_name, std::ios::binary};
+
+        if (!input_file)
+            return std::nullopt;
+
+        file.buffer_.assign(std::istreambuf_iterator<char>{input_file}, std::istreambuf_iterator<char>{});
+#else
+        int fd = ::open(file_name.c_str(), O_RDONLY);
+
+        if (fd == -1)
+            return std::nullopt;
+
+        struct stat file_stat;
+
+        if (::fstat(fd, &file_stat) == -1)
+        {
+            ::close(fd);
+            return std::nullopt;
+        }
+
+        if (file_stat.st_size > 0) // mmap() of an empty file fails - an empty mapping is a valid result
+        {
+            void* address = ::mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (address == MAP_FAILED)
+            {
+                ::close(fd);
+                return std::nullopt;
+            }
+
+            ::madvise(address, file_stat.st_size, MADV_SEQUENTIAL);
+
+            file.address_ = address;
+            file.size_ = file_stat.st_size;
+        }
+
+        ::close(fd); // the mapping keeps its own reference to the file
+#endif
+
+        return file;
+    }
+};
+
+// Zero-copy counterpart of DocumentContent - tokens are views into the mapped file
+class DocumentView
+{
+    MappedFile file_;
+    std::vector<std::string_view> tokens_;
+
+public:
+    using value_type = std::string_view;
+    using const_iterator = std::vector<std::string_view>::const_iterator;
+    using iterator = const_iterator;
+
+    DocumentView() = default;
+
+    DocumentView(MappedFile file, std::vector<std::string_view> tokens)
+        : file_{std::move(file)}, tokens_{std::move(tokens)}
+    {
+    }
+
+    const_iterator begin() const { return tokens_.begin(); }
+    const_iterator end() const { return tokens_.end(); }
+
+    size_t size() const { return tokens_.size(); }
+    bool empty() const { return tokens_.empty(); }
+
+    std::string_view operator[](size_t index) const { return tokens_[index]; }
+    std::string_view front() const { return tokens_.front(); }
+    std::string_view back() const { return tokens_.back(); }
+
+    // content of the mapped file (the text for load_words_mapped(), the binary file for BinaryCorpus::into_view())
+    std::string_view text() const
+    {
+        return file_.content();
+    }
+};
+
+inline std::optional<DocumentView> load_words_mapped(const std::string& file_name)
+{
+    auto file = MappedFile::open(file_name);
+
+    if (!file)
+        return std::nullopt;
+
+    auto tokens = split_words_parallel(file->content());
+
+    return DocumentView{std::move(*file), std::move(tokens)};
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef DATASETS_HPP
+#define DATASETS_HPP
+
+#include <charconv>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <typeindex>
+#include <utility>
+
+// Registry of lazily built, shared benchmark datasets.
+// A dataset is identified by its type and name; each requested size is built once on first use and then cached.
+class DatasetRegistry
+{
+    using Factory = std::function<std::shared_ptr<const void>(size_t)>;
+
+    std::map<std::pair<std::type_index, std::string>, Factory> factories_;
+    std::map<std::tuple<std::type_index, std::string, size_t>, std::shared_ptr<const void>> cache_;
+    std::map<std::string, size_t> sizes_;
+    mutable std::recursive_mutex mtx_; // factories may request other datasets
+
+public:
+    template <typename T, typename Function>
+    void add(const std::string& name, Function factory)
+    {
+        std::lock_guard lk{mtx_};
+        factories_[{typeid(T), name}] = [factory](size_t size) -> std::shared_ptr<const void> { return std::make_shared<const T>(factory(size)); };
+    }
+
+    template <typename T>
+    const T& get(const std::string& name)
+    {
+        return get<T>(name, size(name));
+    }
+
+    template <typename T>
+    const T& get(const std::string& name, size_t size)
+    {
+        std::lock_guard lk{mtx_};
+
+        const auto key = std::make_tuple(std::type_index{typeid(T)}, name, size);
+
+        if (auto it = cache_.find(key); it != cache_.end())
+            return *static_cast<const T*>(it->second.get());
+
+        auto factory = factories_.find({typeid(T), name});
+
+        if (factory == factories_.end())
+            throw std::out_of_range("Unknown dataset: " + name);
+
+        auto dataset = factory->second(size);
+        cache_.emplace(key, dataset);
+
+        return *static_cast<const T*>(dataset.get());
+    }
+
+    // default size for all datasets with the given name - the value set last wins
+    void set_size(const std::string& name, size_t size)
+    {
+        std::lock_guard lk{mtx_};
+        sizes_[name] = size;
+    }
+
+    // parses "name=size" (e.g. "words=1000000")
+    bool set_size(std::string_view name_and_size)
+    {
+        const auto separator = name_and_size.find('=');
+
+        if (separator == std::string_view::npos || separator == 0)
+            return false;
+
+        const auto size_text = name_and_size.substr(separator + 1);
+        size_t size{};
+        auto [end, error] = std::from_chars(size_text.data(), size_text.data() + size_text.size(), size);
+
+        if (error != std::errc{} || end != size_text.data() + size_text.size())
+            return false;
+
+        set_size(std::string(name_and_size.substr(0, separator)), size);
+        return true;
+    }
+
+    size_t size(const std::string& name) const
+    {
+        std::lock_guard lk{mtx_};
+
+        if (auto it = sizes_.find(name); it != sizes_.end())
+            return it->second;
+
+        throw std::out_of_range("No size set for dataset: " + name);
+    }
+};
+
+inline DatasetRegistry& datasets()
+{
+    static DatasetRegistry registry;
+    return registry;
+}
+
+#endif
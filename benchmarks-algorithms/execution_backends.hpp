@@ -0,0 +1,302 @@
+#ifndef EXECUTION_BACKENDS_HPP
+#define EXECUTION_BACKENDS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "parallel_merge_sort.hpp"
+#include "thread_pool.hpp"
+
+// Custom backends usable wherever the benchmarks take a standard execution policy
+struct ThreadPoolPolicy
+{
+    ThreadPool* pool;
+};
+
+#if defined(_OPENMP)
+struct OpenMPPolicy
+{
+};
+#endif
+
+inline std::string policy_name(const std::execution::sequenced_policy&) { return "sequenced"; }
+inline std::string policy_name(const std::execution::parallel_policy&) { return "parallel"; }
+inline std::string policy_name(const std::execution::parallel_unsequenced_policy&) { return "parallel unsequenced"; }
+inline std::string policy_name(const ThreadPoolPolicy&) { return "thread pool"; }
+#if defined(_OPENMP)
+inline std::string policy_name(const OpenMPPolicy&) { return "OpenMP"; }
+#endif
+
+// Calls f(policy) for every standard policy and every custom backend compiled in,
+// so a kernel written once is benchmarked under all of them
+template <typename Function>
+void for_each_policy(ThreadPool& pool, Function f)
+{
+    f(std::execution::seq);
+    f(std::execution::par);
+    f(std::execution::par_unseq);
+    f(ThreadPoolPolicy{&pool});
+#if defined(_OPENMP)
+    f(OpenMPPolicy{});
+#endif
+}
+
+// Algorithms taking either kind of policy: standard policies go to the standard library,
+// custom backends only provide no_of_chunks() and run_chunks() and share the chunked implementations below
+// (standard policies get the same two functions for algorithms the standard library lacks)
+namespace ExecutionBackends
+{
+    template <typename Policy>
+    constexpr bool is_standard_policy = std::is_execution_policy_v<std::decay_t<Policy>>;
+
+    // element functions under par_unseq may be interleaved on one thread - taking a lock there is undefined behavior
+    template <typename Policy>
+    constexpr bool allows_locking = !std::is_same_v<std::decay_t<Policy>, std::execution::parallel_unsequenced_policy>;
+
+    template <typename Policy>
+    using IfStandard = std::enable_if_t<is_standard_policy<Policy>, int>;
+
+    template <typename Policy>
+    using IfCustom = std::enable_if_t<!is_standard_policy<Policy>, int>;
+
+    // standard policies run chunks through std::for_each - one chunk when sequenced
+    template <typename Policy, IfStandard<Policy> = 0>
+    size_t no_of_chunks(const Policy&, size_t size)
+    {
+        if constexpr (std::is_same_v<std::decay_t<Policy>, std::execution::sequenced_policy>)
+            return 1;
+        else
+            return std::clamp<size_t>(4 * std::thread::hardware_concurrency(), 1, std::max<size_t>(size, 1));
+    }
+
+    template <typename Policy, typename Function, IfStandard<Policy> = 0>
+    void run_chunks(const Policy& policy, size_t no_of_chunks, Function f)
+    {
+        std::vector<size_t> chunks(no_of_chunks);
+        std::iota(chunks.begin(), chunks.end(), 0);
+        std::for_each(policy, chunks.begin(), chunks.end(), f);
+    }
+
+    inline size_t no_of_chunks(const ThreadPoolPolicy& policy, size_t size)
+    {
+        return std::clamp<size_t>(4 * policy.pool->size(), 1, std::max<size_t>(size, 1));
+    }
+
+    // calls f(chunk) for chunk in [0, no_of_chunks) and waits for all of them
+    template <typename Function>
+    void run_chunks(const ThreadPoolPolicy& policy, size_t no_of_chunks, Function f)
+    {
+        TaskGroup group{*policy.pool};
+        for (size_t chunk = 1; chunk < no_of_chunks; ++chunk)
+            group.run([=] { f(chunk); });
+
+        if (no_of_chunks > 0)
+            f(0);
+
+        group.wait();
+    }
+
+#if defined(_OPENMP)
+    inline size_t no_of_chunks(const OpenMPPolicy&, size_t size)
+    {
+        return std::clamp<size_t>(4 * omp_get_max_threads(), 1, std::max<size_t>(size, 1));
+    }
+
+    // exceptions must not escape an OpenMP region - f is expected not to throw
+    template <typename Function>
+    void run_chunks(const OpenMPPolicy&, size_t no_of_chunks, Function f)
+    {
+#pragma omp parallel for schedule(dynamic)
+        for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t>(no_of_chunks); ++chunk)
+            f(static_cast<size_t>(chunk));
+    }
+#endif
+
+    inline size_t chunk_begin(size_t chunk, size_t no_of_chunks, size_t size)
+    {
+        return chunk * size / no_of_chunks;
+    }
+
+    template <typename Policy, typename Iterator, typename T, typename Reduce, typename Transform, IfStandard<Policy> = 0>
+    T transform_reduce(Policy&& policy, Iterator first, Iterator last, T init, Reduce reduce, Transform transform)
+    {
+        return std::transform_reduce(policy, first, last, init, reduce, transform);
+    }
+
+    template <typename Policy, typename Iterator, typename T, typename Reduce, typename Transform, IfCustom<Policy> = 0>
+    T transform_reduce(Policy&& policy, Iterator first, Iterator last, T init, Reduce reduce, Transform transform)
+    {
+        const size_t size = last - first;
+        if (size == 0)
+            return init;
+
+        const size_t chunks = no_of_chunks(policy, size);
+        std::vector<T> partial_results(chunks);
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            const auto chunk_first = first + chunk_begin(chunk, chunks, size);
+            const auto chunk_last = first + chunk_begin(chunk + 1, chunks, size);
+            partial_results[chunk] = std::transform_reduce(chunk_first + 1, chunk_last, T(transform(*chunk_first)), reduce, transform);
+        });
+
+        return std::accumulate(partial_results.begin(), partial_results.end(), init, reduce);
+    }
+
+    template <typename Policy, typename Iterator, typename OutputIterator, typename Transform, IfStandard<Policy> = 0>
+    OutputIterator transform(Policy&& policy, Iterator first, Iterator last, OutputIterator out, Transform transform)
+    {
+        return std::transform(policy, first, last, out, transform);
+    }
+
+    template <typename Policy, typename Iterator, typename OutputIterator, typename Transform, IfCustom<Policy> = 0>
+    OutputIterator transform(Policy&& policy, Iterator first, Iterator last, OutputIterator out, Transform transform)
+    {
+        const size_t size = last - first;
+        const size_t chunks = no_of_chunks(policy, size);
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            const size_t begin = chunk_begin(chunk, chunks, size), end = chunk_begin(chunk + 1, chunks, size);
+            std::transform(first + begin, first + end, out + begin, transform);
+        });
+
+        return out + size;
+    }
+
+    template <typename Policy, typename Iterator, typename OutputIterator, typename Reduce, typename Transform, IfStandard<Policy> = 0>
+    OutputIterator transform_inclusive_scan(Policy&& policy, Iterator first, Iterator last, OutputIterator out, Reduce reduce, Transform transform)
+    {
+        return std::transform_inclusive_scan(policy, first, last, out, reduce, transform);
+    }
+
+    // every chunk scans its items, then adds the total of the chunks before it
+    template <typename Policy, typename Iterator, typename OutputIterator, typename Reduce, typename Transform, IfCustom<Policy> = 0>
+    OutputIterator transform_inclusive_scan(Policy&& policy, Iterator first, Iterator last, OutputIterator out, Reduce reduce, Transform transform)
+    {
+        const size_t size = last - first;
+        if (size == 0)
+            return out;
+
+        const size_t chunks = no_of_chunks(policy, size);
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            const size_t begin = chunk_begin(chunk, chunks, size), end = chunk_begin(chunk + 1, chunks, size);
+            std::transform_inclusive_scan(first + begin, first + end, out + begin, reduce, transform);
+        });
+
+        for (size_t chunk = 1; chunk < chunks; ++chunk) // chunk totals -> prefixes
+        {
+            const size_t end = chunk_begin(chunk + 1, chunks, size);
+            out[end - 1] = reduce(out[chunk_begin(chunk, chunks, size) - 1], out[end - 1]);
+        }
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            if (chunk == 0)
+                return;
+
+            const auto prefix = out[chunk_begin(chunk, chunks, size) - 1];
+            for (size_t i = chunk_begin(chunk, chunks, size); i + 1 < chunk_begin(chunk + 1, chunks, size); ++i)
+                out[i] = reduce(prefix, out[i]);
+        });
+
+        return out + size;
+    }
+
+    template <typename Policy, typename Iterator, typename Predicate, IfStandard<Policy> = 0>
+    Iterator partition(Policy&& policy, Iterator first, Iterator last, Predicate pred)
+    {
+        return std::partition(policy, first, last, pred);
+    }
+
+    // Stable partition by precomputed flags (flags[i] != 0 - first[i] goes to the front):
+    // every chunk counts its flags, then scatters its items to a buffer; works with any policy
+    template <typename Policy, typename Iterator, typename FlagIterator>
+    Iterator partition_by_flags(Policy&& policy, Iterator first, Iterator last, FlagIterator flags)
+    {
+        const size_t size = last - first;
+        const size_t chunks = no_of_chunks(policy, size);
+
+        std::vector<size_t> no_of_true(chunks + 1, 0);
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            for (size_t i = chunk_begin(chunk, chunks, size); i < chunk_begin(chunk + 1, chunks, size); ++i)
+                no_of_true[chunk + 1] += flags[i] ? 1 : 0;
+        });
+
+        std::partial_sum(no_of_true.begin(), no_of_true.end(), no_of_true.begin()); // -> trues before every chunk
+        const size_t total_true = no_of_true[chunks];
+
+        std::vector<typename std::iterator_traits<Iterator>::value_type> buffer(size);
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            const size_t begin = chunk_begin(chunk, chunks, size);
+            size_t true_pos = no_of_true[chunk];
+            size_t false_pos = total_true + (begin - no_of_true[chunk]);
+
+            for (size_t i = begin; i < chunk_begin(chunk + 1, chunks, size); ++i)
+                buffer[flags[i] ? true_pos++ : false_pos++] = std::move(first[i]);
+        });
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            const size_t begin = chunk_begin(chunk, chunks, size), end = chunk_begin(chunk + 1, chunks, size);
+            std::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+        });
+
+        return first + total_true;
+    }
+
+    template <typename Policy, typename Iterator, typename Predicate, IfCustom<Policy> = 0>
+    Iterator partition(Policy&& policy, Iterator first, Iterator last, Predicate pred)
+    {
+        std::vector<uint8_t> flags(last - first);
+        transform(policy, first, last, flags.begin(), [&](const auto& item) -> uint8_t { return pred(item) ? 1 : 0; });
+
+        return partition_by_flags(policy, first, last, flags.begin());
+    }
+
+    template <typename Policy, typename Iterator, typename Compare = std::less<>, IfStandard<Policy> = 0>
+    void sort(Policy&& policy, Iterator first, Iterator last, Compare comp = Compare{})
+    {
+        std::sort(policy, first, last, comp);
+    }
+
+    template <typename Iterator, typename Compare = std::less<>>
+    void sort(const ThreadPoolPolicy& policy, Iterator first, Iterator last, Compare comp = Compare{})
+    {
+        parallel_merge_sort(*policy.pool, first, last, comp);
+    }
+
+    // chunks are sorted concurrently, then neighbours are merged pairwise level by level
+    template <typename Policy, typename Iterator, typename Compare = std::less<>, IfCustom<Policy> = 0>
+    void sort(Policy&& policy, Iterator first, Iterator last, Compare comp = Compare{})
+    {
+        const size_t size = last - first;
+        const size_t chunks = no_of_chunks(policy, size);
+
+        run_chunks(policy, chunks, [&](size_t chunk) {
+            std::sort(first + chunk_begin(chunk, chunks, size), first + chunk_begin(chunk + 1, chunks, size), comp);
+        });
+
+        for (size_t width = 1; width < chunks; width *= 2)
+        {
+            run_chunks(policy, (chunks + 2 * width - 1) / (2 * width), [&](size_t pair) {
+                const size_t left = 2 * width * pair;
+                const size_t mid = std::min(left + width, chunks), right = std::min(left + 2 * width, chunks);
+                std::inplace_merge(first + chunk_begin(left, chunks, size), first + chunk_begin(mid, chunks, size),
+                    first + chunk_begin(right, chunks, size), comp);
+            });
+        }
+    }
+}
+
+#endif
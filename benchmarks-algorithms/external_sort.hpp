@@ -0,0 +1,263 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "string_pool.hpp"
+#include "string_sort.hpp"
+#include "token_stream.hpp"
+
+// Winner of a k-way merge in O(log k) comparisons per element; every internal node keeps the loser of its match
+template <typename Less>
+class LoserTree
+{
+    std::vector<size_t> tree_; // tree_[0] - overall winner, tree_[1..k) - losers; leaves k..2k map to sources 0..k
+    size_t no_of_sources_;
+    Less less_;
+
+    size_t build(size_t node)
+    {
+        if (node >= no_of_sources_)
+            return node - no_of_sources_;
+
+        const size_t left = build(2 * node);
+        const size_t right = build(2 * node + 1);
+
+        if (less_(right, left))
+        {
+            tree_[node] = left;
+            return right;
+        }
+
+        tree_[node] = right;
+        return left;
+    }
+
+public:
+    LoserTree(size_t no_of_sources, Less less)
+        : tree_(std::max<size_t>(no_of_sources, 1)), no_of_sources_{no_of_sources}, less_{less}
+    {
+        if (no_of_sources_ > 0)
+            tree_[0] = build(1);
+    }
+
+    size_t winner() const
+    {
+        return tree_[0];
+    }
+
+    // call after the current winner source has advanced
+    void replay()
+    {
+        size_t winner = tree_[0];
+
+        for (size_t node = (winner + no_of_sources_) / 2; node > 0; node /= 2)
+        {
+            if (less_(tree_[node], winner))
+                std::swap(tree_[node], winner);
+        }
+
+        tree_[0] = winner;
+    }
+};
+
+// Sorts token streams larger than memory: runs that fit in memory_limit are sorted in parallel and spilled
+// to temporary files (the next run is read while the previous one is sorted and written),
+// then all runs are merged through a loser tree with buffered reads
+class ExternalSort
+{
+    std::filesystem::path run_directory_; // created for this sorter only, removed with it
+    size_t memory_limit_;
+    std::vector<std::filesystem::path> runs_;
+    std::future<void> pending_spill_;
+    size_t peak_run_memory_ = 0;
+
+    // sorting a run adds a view and a radix sort buffer slot per token to its pool
+    static constexpr size_t sort_bytes_per_token = 2 * sizeof(std::string_view);
+
+    static size_t run_memory(const StringPool& run)
+    {
+        return run.memory_usage() + run.size() * sort_bytes_per_token;
+    }
+
+    // a run that cannot be read throws instead of looking empty - its tokens would be lost from the output
+    class RunReader
+    {
+        std::filesystem::path path_;
+        std::ifstream file_;
+        TokenStream tokens_;
+        const std::vector<std::string_view>* batch_ = nullptr;
+        size_t position_ = 0;
+
+        void next_batch()
+        {
+            batch_ = &tokens_.next_batch();
+            position_ = 0;
+
+            if (file_.bad() || (file_.fail() && !file_.eof()))
+                throw std::runtime_error("Cannot read run file: " + path_.string());
+        }
+
+    public:
+        RunReader(const std::filesystem::path& path, size_t memory_limit)
+            : path_{path}, file_{path, std::ios::binary}, tokens_{file_, memory_limit}
+        {
+            if (!file_)
+                throw std::runtime_error("Cannot open run file: " + path_.string());
+
+            next_batch();
+        }
+
+        bool exhausted() const { return batch_->empty(); }
+        std::string_view current() const { return (*batch_)[position_]; }
+
+        void advance()
+        {
+            if (++position_ == batch_->size())
+                next_batch();
+        }
+    };
+
+    void spill(std::shared_ptr<StringPool> run)
+    {
+        if (pending_spill_.valid())
+            pending_spill_.get();
+
+        peak_run_memory_ = std::max(peak_run_memory_, run_memory(*run));
+
+        const auto path = run_directory_ / ("run_" + std::to_string(runs_.size()));
+        runs_.push_back(path);
+
+        pending_spill_ = std::async(std::launch::async, [run = std::move(run), path] {
+            std::vector<std::string_view> tokens(run->begin(), run->end());
+            msd_radix_sort(std::execution::par, tokens);
+
+            std::ofstream file{path, std::ios::binary};
+            for (const auto& token : tokens)
+                file.write(token.data(), token.size()).put('\n');
+
+            if (!file)
+                throw std::runtime_error("Cannot write run file: " + path.string());
+        });
+    }
+
+    // create_directory() fails for an existing name, so sorters of other threads or processes never share a directory
+    static std::filesystem::path create_run_directory(const std::filesystem::path& parent)
+    {
+        std::random_device rd;
+
+        while (true)
+        {
+            auto directory = parent / ("external_sort_" + std::to_string(rd()) + "_" + std::to_string(rd()));
+
+            if (std::filesystem::create_directory(directory))
+                return directory;
+        }
+    }
+
+public:
+    explicit ExternalSort(size_t memory_limit, const std::filesystem::path& temp_directory = std::filesystem::temp_directory_path())
+        : run_directory_{create_run_directory(temp_directory)}, memory_limit_{memory_limit}
+    {
+    }
+
+    ExternalSort(const ExternalSort&) = delete;
+    ExternalSort& operator=(const ExternalSort&) = delete;
+
+    ~ExternalSort()
+    {
+        if (pending_spill_.valid())
+            pending_spill_.wait();
+
+        std::error_code ec;
+        std::filesystem::remove_all(run_directory_, ec);
+    }
+
+    // Two runs are in memory at a time (one being read, one being sorted) - each must stay below half of the limit.
+    // A run is spilled once its pool and sort buffers reach a quarter of the limit: the push that gets it there
+    // can at most double the pool (when its buffers are reallocated), so the run stays below half (plus one token).
+    void add(TokenStream& tokens)
+    {
+        const size_t run_limit = std::max<size_t>(memory_limit_ / 4, 1);
+        auto run = std::make_shared<StringPool>();
+
+        for_each_batch(tokens, [&](const auto& batch) {
+            for (const auto& token : batch)
+            {
+                run->push_back(token);
+
+                if (run_memory(*run) >= run_limit)
+                {
+                    spill(std::move(run));
+                    run = std::make_shared<StringPool>();
+                }
+            }
+        });
+
+        if (!run->empty())
+            spill(std::move(run));
+    }
+
+    size_t no_of_runs() const
+    {
+        return runs_.size();
+    }
+
+    // largest memory taken by a run while it was sorted (pool + sort buffers)
+    size_t peak_run_memory() const
+    {
+        return peak_run_memory_;
+    }
+
+    // calls consumer(token) for all tokens in sorted order
+    template <typename Consumer>
+    void merge(Consumer consumer)
+    {
+        if (pending_spill_.valid())
+            pending_spill_.get();
+
+        const size_t reader_memory = std::max<size_t>(memory_limit_ / std::max<size_t>(runs_.size(), 1), 4096);
+
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (const auto& run : runs_)
+            readers.push_back(std::make_unique<RunReader>(run, reader_memory));
+
+        auto less = [&](size_t a, size_t b) { // exhausted runs lose every match
+            if (readers[a]->exhausted() || readers[b]->exhausted())
+                return !readers[a]->exhausted() && readers[b]->exhausted();
+
+            return readers[a]->current() < readers[b]->current();
+        };
+
+        LoserTree tree{readers.size(), less};
+
+        while (!readers.empty() && !readers[tree.winner()]->exhausted())
+        {
+            auto& reader = *readers[tree.winner()];
+            consumer(reader.current());
+            reader.advance();
+            tree.replay();
+        }
+    }
+
+    bool merge_to_file(const std::filesystem::path& path)
+    {
+        std::ofstream file{path, std::ios::binary};
+        merge([&](std::string_view token) { file.write(token.data(), token.size()).put('\n'); });
+
+        return static_cast<bool>(file);
+    }
+};
+
+#endif
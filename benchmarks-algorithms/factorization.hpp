@@ -0,0 +1,148 @@
+#ifndef FACTORIZATION_HPP
+#define FACTORIZATION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "execution_backends.hpp"
+#include "miller_rabin.hpp"
+
+// Smallest prime factor of every number up to the limit: a small number is factorized by repeated table lookups
+class SmallestFactorTable
+{
+    std::vector<uint32_t> smallest_factors_;
+
+public:
+    explicit SmallestFactorTable(uint32_t limit)
+        : smallest_factors_(static_cast<size_t>(limit) + 1, 0)
+    {
+        for (uint64_t n = 2; n <= limit; ++n)
+        {
+            if (smallest_factors_[n] != 0)
+                continue;
+
+            smallest_factors_[n] = static_cast<uint32_t>(n);
+            for (uint64_t multiple = n * n; multiple <= limit; multiple += n)
+                if (smallest_factors_[multiple] == 0)
+                    smallest_factors_[multiple] = static_cast<uint32_t>(n);
+        }
+    }
+
+    uint64_t limit() const
+    {
+        return smallest_factors_.size() - 1;
+    }
+
+    // appends the prime factors of 1 <= n <= limit() in ascending order
+    void factorize(uint64_t n, std::vector<uint64_t>& factors) const
+    {
+        for (; n > 1; n /= smallest_factors_[n])
+            factors.push_back(smallest_factors_[n]);
+    }
+};
+
+namespace Factorization
+{
+    constexpr size_t gcd_batch = 128; // differences multiplied together per gcd
+
+    // Pollard's rho with Brent's cycle detection for an odd composite n;
+    // the walk x -> x^2 + c and the product of differences stay in Montgomery form,
+    // which does not change their gcd with n (R = 2^64 is coprime to n)
+    inline uint64_t pollard_brent(uint64_t n)
+    {
+        const MillerRabin::Montgomery mont{n};
+
+        for (uint64_t c = 1;; ++c)
+        {
+            const uint64_t c_mont = mont.to_montgomery(c);
+            auto step = [&](uint64_t x) {
+                const uint64_t square = mont.multiply(x, x);
+                return (square >= n - c_mont) ? square - (n - c_mont) : square + c_mont;
+            };
+            auto distance = [](uint64_t a, uint64_t b) { return a > b ? a - b : b - a; };
+
+            uint64_t x = 0, y = mont.to_montgomery(2), saved_y = y;
+            uint64_t product = mont.one();
+            uint64_t divisor = 1;
+
+            for (size_t length = 1; divisor == 1; length *= 2)
+            {
+                x = y;
+                for (size_t i = 0; i < length; ++i)
+                    y = step(y);
+
+                for (size_t done = 0; done < length && divisor == 1; done += gcd_batch)
+                {
+                    saved_y = y;
+                    for (size_t i = 0; i < std::min(gcd_batch, length - done); ++i)
+                    {
+                        y = step(y);
+                        product = mont.multiply(product, distance(x, y));
+                    }
+                    divisor = std::gcd(product, n);
+                }
+            }
+
+            if (divisor == n) // the batch overshot - repeat its steps one gcd at a time
+            {
+                do
+                {
+                    saved_y = step(saved_y);
+                    divisor = std::gcd(distance(x, saved_y), n);
+                } while (divisor == 1);
+            }
+
+            if (divisor != n)
+                return divisor;
+        }
+    }
+
+    // appends the prime factors of n > 1 without prime factors up to MillerRabin::small_primes.back(), unordered
+    inline void factorize_large(uint64_t n, const SmallestFactorTable& table, std::vector<uint64_t>& factors)
+    {
+        if (n <= table.limit())
+            table.factorize(n, factors);
+        else if (is_prime_miller_rabin(n))
+            factors.push_back(n);
+        else
+        {
+            const uint64_t divisor = pollard_brent(n);
+            factorize_large(divisor, table, factors);
+            factorize_large(n / divisor, table, factors);
+        }
+    }
+}
+
+// Prime factors of n with multiplicity in ascending order (none for 0 and 1)
+inline std::vector<uint64_t> factorize(uint64_t n, const SmallestFactorTable& table)
+{
+    std::vector<uint64_t> factors;
+
+    if (n <= table.limit())
+    {
+        table.factorize(n, factors);
+        return factors;
+    }
+
+    for (uint64_t prime : MillerRabin::small_primes)
+        for (; n % prime == 0; n /= prime)
+            factors.push_back(prime);
+
+    if (n > 1)
+        Factorization::factorize_large(n, table, factors);
+
+    std::sort(factors.begin(), factors.end());
+
+    return factors;
+}
+
+// Batch API: out[i] = factorize(first[i]) under a standard execution policy or a custom backend
+template <typename Policy, typename Iterator, typename OutputIterator>
+OutputIterator factorize_all(Policy&& policy, Iterator first, Iterator last, OutputIterator out, const SmallestFactorTable& table)
+{
+    return ExecutionBackends::transform(policy, first, last, out, [&](uint64_t n) { return factorize(n, table); });
+}
+
+#endif
@@ -0,0 +1,338 @@
+#ifndef FAST_HASH_HPP
+#define FAST_HASH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "execution_backends.hpp"
+#include "wide_arithmetic.hpp"
+
+// Fast non-cryptographic 64-bit hash for byte strings:
+//   - up to 128 bytes: wyhash-style rounds of 64x64->128 bit multiply-and-fold,
+//   - longer inputs: XXH3-style accumulation of 64-byte stripes in 8 lanes (AVX2/SSE2 with an identical scalar path).
+namespace FastHashing
+{
+    constexpr uint64_t prime0 = 0xa0761d6478bd642full;
+    constexpr uint64_t prime1 = 0xe7037ed1a0b428dbull;
+    constexpr uint64_t prime2 = 0x8ebc6af09c88c6e3ull;
+    constexpr uint64_t prime3 = 0x589965cc75374cc3ull;
+    constexpr uint32_t prime32 = 0x9E3779B1u;
+
+    constexpr size_t stripe_size = 64;
+    constexpr size_t stripes_per_block = 16; // accumulators are scrambled after every block
+
+    constexpr std::array<uint64_t, 8> secret = {
+        0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+        0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull};
+
+    inline uint64_t read64(const uint8_t* p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // 64x64 -> 128 bit multiply, both halves folded together
+    inline uint64_t mum(uint64_t a, uint64_t b)
+    {
+        const auto product = WideArithmetic::multiply(a, b);
+        return product.low ^ product.high;
+    }
+
+    // the (a, b) words that hash_short() mixes for a key of at most short_key_size bytes
+    inline void load_short_key(const uint8_t* p, size_t size, uint64_t& a, uint64_t& b)
+    {
+        if (size >= 4)
+        {
+            const size_t quarter = (size >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + quarter);
+            b = (read32(p + size - 4) << 32) | read32(p + size - 4 - quarter);
+        }
+        else if (size > 0)
+        {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[size >> 1]) << 8) | p[size - 1];
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+
+    inline uint64_t hash_short(const uint8_t* p, size_t size, uint64_t seed)
+    {
+        seed ^= mum(seed ^ prime0, prime1);
+        uint64_t a, b;
+
+        if (size <= 16)
+        {
+            load_short_key(p, size, a, b);
+        }
+        else
+        {
+            size_t remaining = size;
+
+            for (; remaining > 16; remaining -= 16, p += 16)
+                seed = mum(read64(p) ^ prime1, read64(p + 8) ^ seed);
+
+            a = read64(p + remaining - 16);
+            b = read64(p + remaining - 8);
+        }
+
+        return mum(prime1 ^ size, mum(a ^ prime1, b ^ seed) ^ prime0);
+    }
+
+    inline void accumulate_stripe_scalar(uint64_t* acc, const uint8_t* p)
+    {
+        for (size_t lane = 0; lane < 8; ++lane)
+        {
+            const uint64_t data = read64(p + 8 * lane);
+            const uint64_t keyed = data ^ secret[lane];
+            acc[lane ^ 1] += data;
+            acc[lane] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+        }
+    }
+
+    inline void scramble_scalar(uint64_t* acc)
+    {
+        for (size_t lane = 0; lane < 8; ++lane)
+            acc[lane] = ((acc[lane] ^ (acc[lane] >> 47)) ^ secret[lane]) * prime32;
+    }
+
+    inline void accumulate_stripe(uint64_t* acc, const uint8_t* p)
+    {
+#if defined(__AVX2__)
+        for (size_t half = 0; half < 2; ++half)
+        {
+            __m256i* lanes = reinterpret_cast<__m256i*>(acc) + half;
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p) + half);
+            const __m256i keyed = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret.data()) + half));
+            const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+            const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)); // data of lane ^ 1
+            _mm256_storeu_si256(lanes, _mm256_add_epi64(_mm256_loadu_si256(lanes), _mm256_add_epi64(product, swapped)));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (size_t quarter = 0; quarter < 4; ++quarter)
+        {
+            __m128i* lanes = reinterpret_cast<__m128i*>(acc) + quarter;
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p) + quarter);
+            const __m128i keyed = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret.data()) + quarter));
+            const __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+            const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            _mm_storeu_si128(lanes, _mm_add_epi64(_mm_loadu_si128(lanes), _mm_add_epi64(product, swapped)));
+        }
+#else
+        accumulate_stripe_scalar(acc, p);
+#endif
+    }
+
+    template <typename AccumulateStripe, typename Scramble>
+    uint64_t hash_long(const uint8_t* p, size_t size, uint64_t seed, AccumulateStripe accumulate, Scramble scramble)
+    {
+        alignas(32) uint64_t acc[8] = {prime32, prime0, prime1, prime2, prime3, prime32 ^ seed, prime1 ^ seed, prime0 + seed};
+
+        const size_t no_of_stripes = (size - 1) / stripe_size; // the last (partial or full) stripe is taken from the end
+        for (size_t stripe = 0; stripe < no_of_stripes; ++stripe)
+        {
+            accumulate(acc, p + stripe * stripe_size);
+
+            if (stripe % stripes_per_block == stripes_per_block - 1)
+                scramble(acc);
+        }
+        accumulate(acc, p + size - stripe_size);
+
+        uint64_t result = size * prime0;
+        for (size_t lane = 0; lane < 8; lane += 2)
+            result += mum(acc[lane] ^ secret[lane], acc[lane + 1] ^ secret[lane + 1]);
+
+        return mum(result ^ seed ^ prime3, prime1 ^ (result >> 29));
+    }
+
+    inline uint64_t hash_long_scalar(const uint8_t* p, size_t size, uint64_t seed)
+    {
+        return hash_long(p, size, seed, accumulate_stripe_scalar, scramble_scalar);
+    }
+
+    constexpr size_t long_input_threshold = 128;
+}
+
+inline uint64_t fast_hash(const void* data, size_t size, uint64_t seed = 0)
+{
+    const auto* p = static_cast<const uint8_t*>(data);
+
+    if (size <= FastHashing::long_input_threshold)
+        return FastHashing::hash_short(p, size, seed);
+
+    return FastHashing::hash_long(p, size, seed, FastHashing::accumulate_stripe, FastHashing::scramble_scalar);
+}
+
+namespace FastHashing
+{
+    constexpr size_t no_of_lanes = 8;
+    constexpr size_t short_key_size = 16;
+
+    // mum() for no_of_lanes pairs at once - the 128 bit product is built from four 32x32->64 bit multiplies
+    inline void mum_lanes(const uint64_t* a, const uint64_t* b, uint64_t* out)
+    {
+#if defined(__AVX2__)
+        const __m256i low_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+
+        for (size_t lane = 0; lane < no_of_lanes; lane += 4)
+        {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + lane));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + lane));
+            const __m256i a_hi = _mm256_srli_epi64(va, 32), b_hi = _mm256_srli_epi64(vb, 32);
+
+            const __m256i lo_lo = _mm256_mul_epu32(va, vb);
+            const __m256i hi_lo = _mm256_mul_epu32(a_hi, vb);
+            const __m256i lo_hi = _mm256_mul_epu32(va, b_hi);
+            const __m256i hi_hi = _mm256_mul_epu32(a_hi, b_hi);
+
+            const __m256i cross = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(lo_lo, 32), _mm256_and_si256(hi_lo, low_mask)), lo_hi);
+            const __m256i high = _mm256_add_epi64(_mm256_add_epi64(hi_hi, _mm256_srli_epi64(hi_lo, 32)), _mm256_srli_epi64(cross, 32));
+            const __m256i low = _mm256_or_si256(_mm256_slli_epi64(cross, 32), _mm256_and_si256(lo_lo, low_mask));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + lane), _mm256_xor_si256(low, high));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128i low_mask = _mm_set1_epi64x(0xFFFFFFFF);
+
+        for (size_t lane = 0; lane < no_of_lanes; lane += 2)
+        {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lane));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + lane));
+            const __m128i a_hi = _mm_srli_epi64(va, 32), b_hi = _mm_srli_epi64(vb, 32);
+
+            const __m128i lo_lo = _mm_mul_epu32(va, vb);
+            const __m128i hi_lo = _mm_mul_epu32(a_hi, vb);
+            const __m128i lo_hi = _mm_mul_epu32(va, b_hi);
+            const __m128i hi_hi = _mm_mul_epu32(a_hi, b_hi);
+
+            const __m128i cross = _mm_add_epi64(_mm_add_epi64(_mm_srli_epi64(lo_lo, 32), _mm_and_si128(hi_lo, low_mask)), lo_hi);
+            const __m128i high = _mm_add_epi64(_mm_add_epi64(hi_hi, _mm_srli_epi64(hi_lo, 32)), _mm_srli_epi64(cross, 32));
+            const __m128i low = _mm_or_si128(_mm_slli_epi64(cross, 32), _mm_and_si128(lo_lo, low_mask));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + lane), _mm_xor_si128(low, high));
+        }
+#else
+        for (size_t lane = 0; lane < no_of_lanes; ++lane)
+            out[lane] = mum(a[lane], b[lane]);
+#endif
+    }
+
+    // hashes no_of_lanes keys; keys longer than short_key_size are hashed one by one
+    template <typename Iterator>
+    void hash_lanes(Iterator first, uint64_t seed, uint64_t mixed_seed, uint64_t* hashes)
+    {
+        alignas(32) uint64_t a[no_of_lanes], b[no_of_lanes], size[no_of_lanes];
+        uint32_t long_keys = 0;
+
+        for (size_t lane = 0; lane < no_of_lanes; ++lane, ++first)
+        {
+            const std::string_view key{*first};
+            size[lane] = key.size();
+
+            if (key.size() <= short_key_size)
+            {
+                load_short_key(reinterpret_cast<const uint8_t*>(key.data()), key.size(), a[lane], b[lane]);
+            }
+            else
+            {
+                long_keys |= 1u << lane;
+                a[lane] = b[lane] = 0;
+                hashes[lane] = fast_hash(key.data(), key.size(), seed);
+            }
+        }
+
+        for (size_t lane = 0; lane < no_of_lanes; ++lane)
+        {
+            a[lane] ^= prime1;
+            b[lane] ^= mixed_seed;
+        }
+        mum_lanes(a, b, a);
+
+        for (size_t lane = 0; lane < no_of_lanes; ++lane)
+        {
+            a[lane] ^= prime0;
+            b[lane] = prime1 ^ size[lane];
+        }
+        mum_lanes(b, a, a);
+
+        for (size_t lane = 0; lane < no_of_lanes; ++lane)
+            if ((long_keys & (1u << lane)) == 0)
+                hashes[lane] = a[lane];
+    }
+
+    constexpr size_t batch_chunk_size = 512;
+}
+
+// Hashes count strings starting at first (anything convertible to std::string_view) into hashes[0..count),
+// FastHashing::no_of_lanes at a time; the results are the same as fast_hash() of every string
+template <typename Iterator>
+void hash_batch(Iterator first, size_t count, uint64_t* hashes, uint64_t seed = 0)
+{
+    using namespace FastHashing;
+
+    const uint64_t mixed_seed = seed ^ mum(seed ^ prime0, prime1);
+    size_t index = 0;
+
+    for (; index + no_of_lanes <= count; index += no_of_lanes, first += no_of_lanes)
+        hash_lanes(first, seed, mixed_seed, hashes + index);
+
+    for (; index < count; ++index, ++first)
+    {
+        const std::string_view key{*first};
+        hashes[index] = fast_hash(key.data(), key.size(), seed);
+    }
+}
+
+// Sum of the hashes of all strings: chunks of strings are batch hashed inside transform_reduce
+// (a standard execution policy or a custom backend)
+template <typename ExecutionPolicy, typename Strings>
+uint64_t sum_of_hashes(ExecutionPolicy&& policy, const Strings& strings, uint64_t seed = 0)
+{
+    using FastHashing::batch_chunk_size;
+
+    std::vector<size_t> chunks((strings.size() + batch_chunk_size - 1) / batch_chunk_size);
+    std::iota(chunks.begin(), chunks.end(), 0);
+
+    return ExecutionBackends::transform_reduce(policy, chunks.begin(), chunks.end(), uint64_t{0}, std::plus{}, [&](size_t chunk) {
+        const size_t first = chunk * batch_chunk_size;
+        const size_t count = std::min(batch_chunk_size, strings.size() - first);
+
+        uint64_t hashes[batch_chunk_size];
+        hash_batch(strings.begin() + first, count, hashes, seed);
+
+        return std::accumulate(hashes, hashes + count, uint64_t{0});
+    });
+}
+
+// drop-in replacement for std::hash<std::string> / std::hash<std::string_view>
+struct FastHash
+{
+    uint64_t seed = 0;
+
+    size_t operator()(std::string_view str) const
+    {
+        return fast_hash(str.data(), str.size(), seed);
+    }
+};
+
+#endif
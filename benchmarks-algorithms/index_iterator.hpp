@@ -0,0 +1,52 @@
+#ifndef INDEX_ITERATOR_HPP
+#define INDEX_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+
+// Random access iterator over containers that hand out elements by value from operator[] (e.g. std::string_view)
+template <typename Container>
+class IndexIterator
+{
+    const Container* container_ = nullptr;
+    size_t index_ = 0;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Container::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    IndexIterator() = default;
+
+    IndexIterator(const Container* container, size_t index)
+        : container_{container}, index_{index}
+    {
+    }
+
+    value_type operator*() const { return (*container_)[index_]; }
+    value_type operator[](difference_type n) const { return (*container_)[index_ + n]; }
+
+    IndexIterator& operator++() { ++index_; return *this; }
+    IndexIterator operator++(int) { auto temp = *this; ++index_; return temp; }
+    IndexIterator& operator--() { --index_; return *this; }
+    IndexIterator operator--(int) { auto temp = *this; --index_; return temp; }
+
+    IndexIterator& operator+=(difference_type n) { index_ += n; return *this; }
+    IndexIterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+    friend IndexIterator operator+(IndexIterator it, difference_type n) { return it += n; }
+    friend IndexIterator operator+(difference_type n, IndexIterator it) { return it += n; }
+    friend IndexIterator operator-(IndexIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const IndexIterator& a, const IndexIterator& b) { return a.index_ - b.index_; }
+
+    friend bool operator==(const IndexIterator& a, const IndexIterator& b) { return a.index_ == b.index_; }
+    friend bool operator!=(const IndexIterator& a, const IndexIterator& b) { return a.index_ != b.index_; }
+    friend bool operator<(const IndexIterator& a, const IndexIterator& b) { return a.index_ < b.index_; }
+    friend bool operator>(const IndexIterator& a, const IndexIterator& b) { return a.index_ > b.index_; }
+    friend bool operator<=(const IndexIterator& a, const IndexIterator& b) { return a.index_ <= b.index_; }
+    friend bool operator>=(const IndexIterator& a, const IndexIterator& b) { return a.index_ >= b.index_; }
+};
+
+#endif
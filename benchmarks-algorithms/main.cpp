@@ -1,4 +1,31 @@
-#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_RUNNER
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
 
-#include "catch.hpp"
\ No newline at end of file
+#include "catch.hpp"
+#include "datasets.hpp"
+
+int main(int argc, char* argv[])
+{
+    Catch::Session session;
+
+    std::vector<std::string> dataset_sizes;
+
+    using namespace Catch::clara;
+    auto cli = session.cli()
+        | Opt(dataset_sizes, "name=size")["--dataset-size"]("size of a benchmark dataset, e.g. words=1000000 or numbers=100000000");
+    session.cli(cli);
+
+    if (int return_code = session.applyCommandLine(argc, argv); return_code != 0)
+        return return_code;
+
+    for (const auto& name_and_size : dataset_sizes)
+    {
+        if (!datasets().set_size(name_and_size))
+        {
+            std::cerr << "Invalid dataset size: " << name_and_size << "\n";
+            return 1;
+        }
+    }
+
+    return session.run();
+}
@@ -0,0 +1,179 @@
+#ifndef MEMOIZATION_HPP
+#define MEMOIZATION_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Caches for pure functions shared by concurrent callers (e.g. inside std::execution::par algorithms).
+// Two threads may compute the same value at the same time - both store the same result, so the race is harmless.
+
+struct MemoStats
+{
+    size_t hits;
+    size_t misses;
+
+    double hit_rate() const
+    {
+        return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses);
+    }
+};
+
+namespace Memoization
+{
+    // hit/miss counters spread over cache lines, so counting does not serialize the callers
+    class Counters
+    {
+        static constexpr size_t no_of_slots = 16;
+
+        struct alignas(64) Slot
+        {
+            std::atomic<size_t> hits{0};
+            std::atomic<size_t> misses{0};
+        };
+
+        std::array<Slot, no_of_slots> slots_;
+
+    public:
+        void count(size_t key_hash, bool hit)
+        {
+            auto& slot = slots_[key_hash % no_of_slots];
+            (hit ? slot.hits : slot.misses).fetch_add(1, std::memory_order_relaxed);
+        }
+
+        MemoStats stats() const
+        {
+            MemoStats stats{0, 0};
+            for (const auto& slot : slots_)
+            {
+                stats.hits += slot.hits.load(std::memory_order_relaxed);
+                stats.misses += slot.misses.load(std::memory_order_relaxed);
+            }
+            return stats;
+        }
+    };
+}
+
+// Predicate results for arguments in [0, limit] as two bits per value (known, result) in atomic words:
+// a lookup is one relaxed load, a store one fetch_or; larger arguments are evaluated without caching
+template <typename Predicate>
+class DenseMemo
+{
+    static constexpr uint64_t values_per_word = 32;
+
+    Predicate predicate_;
+    uint64_t limit_;
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    Memoization::Counters counters_;
+
+public:
+    DenseMemo(Predicate predicate, uint64_t limit)
+        : predicate_{std::move(predicate)}, limit_{limit}, words_{std::make_unique<std::atomic<uint64_t>[]>(limit / values_per_word + 1)}
+    {
+        for (uint64_t word = 0; word <= limit / values_per_word; ++word)
+            words_[word].store(0, std::memory_order_relaxed);
+    }
+
+    bool operator()(uint64_t value)
+    {
+        if (value > limit_)
+        {
+            counters_.count(value, false);
+            return predicate_(value);
+        }
+
+        auto& word = words_[value / values_per_word];
+        const unsigned shift = 2 * (value % values_per_word);
+        const uint64_t bits = (word.load(std::memory_order_relaxed) >> shift) & 3;
+
+        if (bits & 2)
+        {
+            counters_.count(value, true);
+            return bits & 1;
+        }
+
+        const bool result = predicate_(value);
+        word.fetch_or(uint64_t{2 | static_cast<unsigned>(result)} << shift, std::memory_order_relaxed);
+        counters_.count(value, false);
+
+        return result;
+    }
+
+    MemoStats stats() const
+    {
+        return counters_.stats();
+    }
+};
+
+// Results of any function in a hash map split into shards with a reader-writer lock each;
+// the function runs outside of the locks (so not usable under std::execution::par_unseq)
+template <typename Key, typename Value, typename Function, typename Hash = std::hash<Key>>
+class ShardedMemo
+{
+    struct alignas(64) Shard
+    {
+        std::shared_mutex mtx;
+        std::unordered_map<Key, Value, Hash> values;
+    };
+
+    Function function_;
+    std::vector<Shard> shards_;
+    Memoization::Counters counters_;
+
+public:
+    explicit ShardedMemo(Function function, size_t no_of_shards = 64)
+        : function_{std::move(function)}, shards_(no_of_shards)
+    {
+    }
+
+    Value operator()(const Key& key)
+    {
+        const size_t key_hash = Hash{}(key);
+        auto& shard = shards_[key_hash % shards_.size()];
+
+        {
+            std::shared_lock lk{shard.mtx};
+            if (auto it = shard.values.find(key); it != shard.values.end())
+            {
+                counters_.count(key_hash, true);
+                return it->second;
+            }
+        }
+
+        Value value = function_(key);
+        counters_.count(key_hash, false);
+
+        std::unique_lock lk{shard.mtx};
+        shard.values.emplace(key, value);
+
+        return value;
+    }
+
+    MemoStats stats() const
+    {
+        return counters_.stats();
+    }
+};
+
+template <typename Predicate>
+DenseMemo<Predicate> memoize_dense(Predicate predicate, uint64_t limit)
+{
+    return DenseMemo<Predicate>{std::move(predicate), limit};
+}
+
+template <typename Key, typename Function>
+auto memoize_sharded(Function function, size_t no_of_shards = 64)
+{
+    using Value = std::decay_t<decltype(function(std::declval<const Key&>()))>;
+    return ShardedMemo<Key, Value, Function>{std::move(function), no_of_shards};
+}
+
+#endif
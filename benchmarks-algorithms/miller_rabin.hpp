@@ -0,0 +1,141 @@
+#ifndef MILLER_RABIN_HPP
+#define MILLER_RABIN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "execution_backends.hpp"
+#include "wide_arithmetic.hpp"
+
+// Deterministic Miller-Rabin for the whole uint64_t range: the 7 witnesses of Jim Sinclair are enough below 2^64.
+// Modular multiplications use Montgomery form, so the hot loop has no 128-bit division.
+namespace MillerRabin
+{
+    constexpr std::array<uint64_t, 7> witnesses = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    constexpr std::array<uint64_t, 3> witnesses_32 = {2, 7, 61}; // enough below 4'759'123'141 (Jaeschke)
+
+    constexpr std::array<uint32_t, 16> small_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+    constexpr uint64_t prefilter_bound = 59 * 59; // numbers below it without a small prime factor are primes
+
+    // arithmetic modulo an odd n with R = 2^64; values in Montgomery form are a * R mod n
+    class Montgomery
+    {
+        uint64_t n_;
+        uint64_t n_inverse_; // n * n_inverse_ == 1 (mod 2^64)
+        uint64_t r_squared_; // R^2 mod n
+        uint64_t one_;       // R mod n
+
+    public:
+        explicit Montgomery(uint64_t n)
+            : n_{n}, n_inverse_{WideArithmetic::inverse_mod_2_64(n)}
+        {
+            one_ = (0 - n) % n;
+            r_squared_ = one_;
+            for (int i = 0; i < 64; ++i) // doubling R mod n 64 times gives R^2 mod n
+                r_squared_ = (r_squared_ >= n - r_squared_) ? r_squared_ - (n - r_squared_) : 2 * r_squared_;
+        }
+
+        // (a * b) / R mod n for a, b < n
+        uint64_t multiply(uint64_t a, uint64_t b) const
+        {
+            const uint64_t low = a * b;
+            const uint64_t high = WideArithmetic::mul_high(a, b);
+            const uint64_t m = low * n_inverse_;      // a * b - m * n is divisible by R
+            const uint64_t mn_high = WideArithmetic::mul_high(m, n_); // (a * b - m * n) / R = high - mn_high
+
+            return (high >= mn_high) ? high - mn_high : high - mn_high + n_;
+        }
+
+        uint64_t to_montgomery(uint64_t a) const
+        {
+            return multiply(a % n_, r_squared_);
+        }
+
+        uint64_t one() const
+        {
+            return one_;
+        }
+
+        uint64_t power(uint64_t base, uint64_t exponent) const // base in Montgomery form
+        {
+            uint64_t result = one();
+
+            for (; exponent > 0; exponent >>= 1)
+            {
+                if (exponent & 1)
+                    result = multiply(result, base);
+                base = multiply(base, base);
+            }
+
+            return result;
+        }
+    };
+
+    // n odd, n > prefilter_bound
+    inline bool is_strong_probable_prime(const Montgomery& mont, uint64_t n, uint64_t witness)
+    {
+        const uint64_t one = mont.one();
+        const uint64_t minus_one = n - one;
+
+        uint64_t d = n - 1;
+        int s = 0;
+        for (; d % 2 == 0; d /= 2)
+            ++s;
+
+        const uint64_t a = mont.to_montgomery(witness);
+        if (a == 0) // witness is a multiple of n
+            return true;
+
+        uint64_t x = mont.power(a, d);
+        if (x == one || x == minus_one)
+            return true;
+
+        for (int i = 1; i < s; ++i)
+        {
+            x = mont.multiply(x, x);
+            if (x == minus_one)
+                return true;
+        }
+
+        return false;
+    }
+
+    // the test proper for odd n above prefilter_bound (callers that filter small factors themselves start here)
+    inline bool passes_witnesses(uint64_t n)
+    {
+        const Montgomery mont{n};
+        auto passes = [&](uint64_t witness) { return is_strong_probable_prime(mont, n, witness); };
+
+        if (n < (uint64_t{1} << 32))
+            return std::all_of(witnesses_32.begin(), witnesses_32.end(), passes);
+
+        return std::all_of(witnesses.begin(), witnesses.end(), passes);
+    }
+}
+
+inline bool is_prime_miller_rabin(uint64_t n)
+{
+    using namespace MillerRabin;
+
+    if (n < 2)
+        return false;
+
+    for (uint32_t prime : small_primes)
+        if (n % prime == 0)
+            return n == prime;
+
+    if (n < prefilter_bound)
+        return true;
+
+    return passes_witnesses(n);
+}
+
+// Batch API: out[i] = is_prime_miller_rabin(first[i]) under a standard execution policy or a custom backend
+template <typename Policy, typename Iterator, typename OutputIterator>
+OutputIterator are_primes(Policy&& policy, Iterator first, Iterator last, OutputIterator out)
+{
+    return ExecutionBackends::transform(policy, first, last, out, [](uint64_t n) { return is_prime_miller_rabin(n); });
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PARALLEL_MERGE_SORT_HPP
+#define PARALLEL_MERGE_SORT_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+// Merge sort on a work-stealing ThreadPool: ranges up to grain_size are sorted with std::sort,
+// both halves and the merges are split recursively into TaskGroup tasks
+namespace ParallelMergeSort
+{
+    // moves sorted [first1, last1) and [first2, last2) into out
+    template <typename InputIterator, typename OutputIterator, typename Compare>
+    void merge(ThreadPool& pool, InputIterator first1, InputIterator last1, InputIterator first2, InputIterator last2,
+        OutputIterator out, Compare comp, size_t grain_size)
+    {
+        if (last1 - first1 < last2 - first2)
+        {
+            std::swap(first1, first2);
+            std::swap(last1, last2);
+        }
+
+        if (static_cast<size_t>((last1 - first1) + (last2 - first2)) <= grain_size)
+        {
+            std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+                std::make_move_iterator(first2), std::make_move_iterator(last2), out, comp);
+            return;
+        }
+
+        // the middle of the longer range splits the output: everything before it goes left, the rest goes right
+        const auto mid1 = first1 + (last1 - first1) / 2;
+        const auto mid2 = std::lower_bound(first2, last2, *mid1, comp);
+        const auto out_mid = out + (mid1 - first1) + (mid2 - first2);
+        *out_mid = std::move(*mid1);
+
+        TaskGroup group{pool};
+        group.run([=, &pool] { merge(pool, first1, mid1, first2, mid2, out, comp, grain_size); });
+        merge(pool, mid1 + 1, last1, mid2, last2, out_mid + 1, comp, grain_size);
+        group.wait();
+    }
+
+    // sorts [first, last); the result lands in [first, last) or - if into_buffer - in [buffer, buffer + size)
+    template <typename RandomIterator, typename BufferIterator, typename Compare>
+    void sort(ThreadPool& pool, RandomIterator first, RandomIterator last, BufferIterator buffer, bool into_buffer,
+        Compare comp, size_t grain_size)
+    {
+        const auto size = last - first;
+
+        if (static_cast<size_t>(size) <= grain_size)
+        {
+            std::sort(first, last, comp);
+
+            if (into_buffer)
+                std::move(first, last, buffer);
+
+            return;
+        }
+
+        const auto half = size / 2;
+
+        // halves end up in the other array, so every level merges without copying back
+        TaskGroup group{pool};
+        group.run([=, &pool] { sort(pool, first, first + half, buffer, !into_buffer, comp, grain_size); });
+        sort(pool, first + half, last, buffer + half, !into_buffer, comp, grain_size);
+        group.wait();
+
+        if (into_buffer)
+            merge(pool, first, first + half, first + half, last, buffer, comp, grain_size);
+        else
+            merge(pool, buffer, buffer + half, buffer + half, buffer + size, first, comp, grain_size);
+    }
+}
+
+template <typename RandomIterator, typename Compare = std::less<>>
+void parallel_merge_sort(ThreadPool& pool, RandomIterator first, RandomIterator last, Compare comp = Compare{}, size_t grain_size = 4096)
+{
+    std::vector<typename std::iterator_traits<RandomIterator>::value_type> buffer(last - first);
+    ParallelMergeSort::sort(pool, first, last, buffer.begin(), false, comp, std::max<size_t>(grain_size, 1));
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef PRIME_SIEVE_HPP
+#define PRIME_SIEVE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <stdexcept>
+#include <vector>
+
+#include "execution_backends.hpp"
+
+// Segmented sieve of Eratosthenes over odd numbers only: bit i stands for 2i + 1.
+// Segments own whole 64-bit words and fit in L1 cache, so they are sieved independently (in parallel for parallel policies and custom backends).
+class PrimeSieve
+{
+    static constexpr size_t segment_words = 4096; // 32 KiB of bits = 262144 odd numbers
+
+    std::vector<uint64_t> bits_;
+    uint64_t limit_;
+
+    static std::vector<uint32_t> odd_base_primes(uint64_t limit)
+    {
+        uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(limit)));
+        while (root * root > limit)
+            --root;
+        while ((root + 1) * (root + 1) <= limit)
+            ++root;
+
+        std::vector<char> is_composite(root + 1, 0);
+        std::vector<uint32_t> primes;
+
+        for (uint64_t n = 3; n <= root; n += 2)
+        {
+            if (is_composite[n])
+                continue;
+
+            primes.push_back(static_cast<uint32_t>(n));
+            for (uint64_t multiple = n * n; multiple <= root; multiple += 2 * n)
+                is_composite[multiple] = 1;
+        }
+
+        return primes;
+    }
+
+    void sieve_segment(size_t segment, const std::vector<uint32_t>& base_primes)
+    {
+        const uint64_t first_index = segment * segment_words * 64;
+        const uint64_t last_index = std::min<uint64_t>(first_index + segment_words * 64, bits_.size() * 64);
+        const uint64_t first_number = 2 * first_index + 1, last_number = 2 * last_index + 1; // [first_number, last_number)
+
+        for (uint32_t prime : base_primes)
+        {
+            uint64_t multiple = static_cast<uint64_t>(prime) * prime;
+            if (multiple >= last_number)
+                break;
+
+            if (multiple < first_number)
+            {
+                multiple = (first_number + prime - 1) / prime * prime;
+                if (multiple % 2 == 0)
+                    multiple += prime;
+            }
+
+            for (uint64_t index = (multiple - 1) / 2; index < last_index; index += prime)
+                bits_[index / 64] &= ~(uint64_t{1} << (index % 64));
+        }
+    }
+
+public:
+    template <typename ExecutionPolicy>
+    PrimeSieve(ExecutionPolicy&& policy, uint64_t limit)
+        : bits_(limit / 128 + 1, ~uint64_t{0}), limit_{limit}
+    {
+        bits_[0] &= ~uint64_t{1}; // 1 is not a prime
+
+        const auto base_primes = odd_base_primes(limit);
+
+        const size_t no_of_segments = (bits_.size() + segment_words - 1) / segment_words;
+        ExecutionBackends::run_chunks(policy, no_of_segments, [&](size_t segment) { sieve_segment(segment, base_primes); });
+    }
+
+    uint64_t limit() const
+    {
+        return limit_;
+    }
+
+    bool is_prime(uint64_t number) const
+    {
+        if (number > limit_)
+            throw std::out_of_range("Number is above the sieve limit");
+
+        if (number % 2 == 0)
+            return number == 2;
+
+        const uint64_t index = number / 2;
+        return (bits_[index / 64] >> (index % 64)) & 1;
+    }
+};
+
+// sieve large enough for every number of the batch
+template <typename ExecutionPolicy, typename Numbers>
+PrimeSieve sieve_for(ExecutionPolicy&& policy, const Numbers& numbers)
+{
+    const uint64_t limit = numbers.empty() ? 2 : *std::max_element(numbers.begin(), numbers.end());
+    return PrimeSieve{policy, limit};
+}
+
+#endif
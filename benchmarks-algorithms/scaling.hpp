@@ -0,0 +1,169 @@
+#ifndef SCALING_HPP
+#define SCALING_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __has_include(<tbb/task_arena.h>)
+#include <tbb/task_arena.h>
+#define SCALING_HAS_TBB_ARENA 1
+#endif
+
+// 1, 2, 4, ... up to (and always including) max_no_of_threads
+inline std::vector<size_t> thread_count_sweep(size_t max_no_of_threads = std::thread::hardware_concurrency())
+{
+    max_no_of_threads = std::max<size_t>(max_no_of_threads, 1);
+
+    std::vector<size_t> thread_counts;
+    for (size_t no_of_threads = 1; no_of_threads < max_no_of_threads; no_of_threads *= 2)
+        thread_counts.push_back(no_of_threads);
+    thread_counts.push_back(max_no_of_threads);
+
+    return thread_counts;
+}
+
+// Runs f() with the standard parallel algorithms (TBB backend) limited to no_of_threads;
+// without TBB the standard library decides and f() runs unlimited
+template <typename Function>
+auto run_with_threads(size_t no_of_threads, Function f)
+{
+#if defined(SCALING_HAS_TBB_ARENA)
+    tbb::task_arena arena{static_cast<int>(no_of_threads)};
+    return arena.execute(f);
+#else
+    (void)no_of_threads;
+    return f();
+#endif
+}
+
+// One arena per thread count, created and initialized up front: kernels measured with run() only enter an arena,
+// so arena setup is not timed (run_with_threads() builds a new arena on every call)
+class ThreadArenas
+{
+    std::vector<size_t> thread_counts_;
+#if defined(SCALING_HAS_TBB_ARENA)
+    std::vector<std::unique_ptr<tbb::task_arena>> arenas_;
+#endif
+
+public:
+    explicit ThreadArenas(const std::vector<size_t>& thread_counts)
+        : thread_counts_{thread_counts}
+    {
+#if defined(SCALING_HAS_TBB_ARENA)
+        for (size_t no_of_threads : thread_counts_)
+        {
+            arenas_.push_back(std::make_unique<tbb::task_arena>(static_cast<int>(no_of_threads)));
+            arenas_.back()->initialize();
+        }
+#endif
+    }
+
+    // f() limited to no_of_threads, which must be one of the thread counts of the constructor
+    template <typename Function>
+    auto run(size_t no_of_threads, Function f)
+    {
+        const auto it = std::find(thread_counts_.begin(), thread_counts_.end(), no_of_threads);
+        if (it == thread_counts_.end())
+            throw std::out_of_range("No arena for " + std::to_string(no_of_threads) + " threads");
+
+#if defined(SCALING_HAS_TBB_ARENA)
+        return arenas_[it - thread_counts_.begin()]->execute(f);
+#else
+        return f();
+#endif
+    }
+};
+
+struct ScalingPoint
+{
+    size_t no_of_threads;
+    double seconds;    // median of the runs
+    double speedup;    // T(1) / T(p)
+    double efficiency; // speedup / p
+    std::optional<double> serial_fraction; // Karp-Flatt: (1/speedup - 1/p) / (1 - 1/p) - Amdahl's serial part; none for p = 1
+};
+
+inline std::optional<double> karp_flatt_serial_fraction(double speedup, size_t no_of_threads)
+{
+    if (no_of_threads < 2 || speedup <= 0.0)
+        return std::nullopt;
+
+    const double p = static_cast<double>(no_of_threads);
+    return (1.0 / speedup - 1.0 / p) / (1.0 - 1.0 / p);
+}
+
+// seconds[i] - time with thread_counts[i] threads; thread_counts[0] is the baseline (normally 1 thread)
+inline std::vector<ScalingPoint> scaling_points(const std::vector<size_t>& thread_counts, const std::vector<double>& seconds)
+{
+    std::vector<ScalingPoint> points;
+
+    for (size_t i = 0; i < thread_counts.size() && i < seconds.size(); ++i)
+    {
+        const double speedup = seconds[i] > 0.0 ? seconds[0] / seconds[i] : 0.0;
+        points.push_back({thread_counts[i], seconds[i], speedup, speedup / thread_counts[i], karp_flatt_serial_fraction(speedup, thread_counts[i])});
+    }
+
+    return points;
+}
+
+// Times kernel(no_of_threads, state) no_of_runs times for every thread count (after one warm-up run);
+// every run gets fresh state from setup() before its timer starts, so preparing inputs is not counted as serial time
+template <typename Setup, typename Kernel>
+std::vector<ScalingPoint> measure_scaling(Setup setup, Kernel kernel, const std::vector<size_t>& thread_counts, size_t no_of_runs = 5)
+{
+    std::vector<double> medians;
+
+    for (size_t no_of_threads : thread_counts)
+    {
+        auto warm_up_state = setup();
+        kernel(no_of_threads, warm_up_state);
+
+        std::vector<double> times;
+        for (size_t run = 0; run < std::max<size_t>(no_of_runs, 1); ++run)
+        {
+            auto state = setup();
+
+            const auto start = std::chrono::steady_clock::now();
+            kernel(no_of_threads, state);
+            times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        medians.push_back(times[times.size() / 2]);
+    }
+
+    return scaling_points(thread_counts, medians);
+}
+
+// kernel(no_of_threads) without per-run state
+template <typename Kernel>
+std::vector<ScalingPoint> measure_scaling(Kernel kernel, const std::vector<size_t>& thread_counts, size_t no_of_runs = 5)
+{
+    return measure_scaling([] { return 0; }, [&](size_t no_of_threads, int) { kernel(no_of_threads); }, thread_counts, no_of_runs);
+}
+
+inline void print_scaling(std::ostream& out, const std::string& name, const std::vector<ScalingPoint>& points)
+{
+    out << name << "\n"
+        << std::setw(10) << "threads" << std::setw(14) << "time [ms]" << std::setw(10) << "speedup"
+        << std::setw(12) << "efficiency" << std::setw(17) << "serial fraction" << "\n";
+
+    for (const auto& point : points)
+    {
+        out << std::setw(10) << point.no_of_threads << std::fixed << std::setprecision(3)
+            << std::setw(14) << point.seconds * 1000 << std::setw(10) << point.speedup << std::setw(12) << point.efficiency
+            << std::setw(17) << (point.serial_fraction ? std::to_string(*point.serial_fraction) : std::string("-")) << "\n";
+    }
+
+    out << std::defaultfloat << std::endl;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef STRING_POOL_HPP
+#define STRING_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "index_iterator.hpp"
+
+// All characters in one contiguous buffer + packed (offset, length) array - iterates as std::string_view
+class StringPool
+{
+    struct Entry
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::vector<char> chars_;
+    std::vector<Entry> entries_;
+
+public:
+    using value_type = std::string_view;
+    using size_type = size_t;
+
+    using const_iterator = IndexIterator<StringPool>;
+    using iterator = const_iterator;
+
+    StringPool() = default;
+
+    template <typename InputIterator>
+    StringPool(InputIterator first, InputIterator last)
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>)
+        {
+            size_t no_of_chars = 0;
+            for (auto it = first; it != last; ++it)
+                no_of_chars += std::string_view(*it).size();
+
+            reserve(std::distance(first, last), no_of_chars);
+        }
+
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    void reserve(size_t no_of_strings, size_t no_of_chars)
+    {
+        entries_.reserve(no_of_strings);
+        chars_.reserve(no_of_chars);
+    }
+
+    // offsets are 32-bit - a pool holds at most 4 GiB of characters
+    void push_back(std::string_view str)
+    {
+        if (str.size() > std::numeric_limits<uint32_t>::max() - chars_.size())
+            throw std::length_error("StringPool holds at most 4 GiB of characters");
+
+        entries_.push_back(Entry{static_cast<uint32_t>(chars_.size()), static_cast<uint32_t>(str.size())});
+        chars_.insert(chars_.end(), str.begin(), str.end());
+    }
+
+    std::string_view operator[](size_t index) const
+    {
+        const Entry& entry = entries_[index];
+        return {chars_.data() + entry.offset, entry.length};
+    }
+
+    std::string_view front() const { return (*this)[0]; }
+    std::string_view back() const { return (*this)[size() - 1]; }
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    size_t memory_usage() const
+    {
+        return chars_.capacity() * sizeof(char) + entries_.capacity() * sizeof(Entry);
+    }
+};
+
+#endif
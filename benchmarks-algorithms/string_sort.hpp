@@ -0,0 +1,285 @@
+#ifndef STRING_SORT_HPP
+#define STRING_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "case_folding.hpp"
+#include "execution_backends.hpp"
+
+// Collation keys: every string is folded once into one shared buffer (decorate),
+// indices are sorted by the keys (sort) and the strings are permuted accordingly (undecorate).
+class CollationKeys
+{
+    std::vector<char> chars_;
+    std::vector<size_t> offsets_;
+
+public:
+    template <typename ExecutionPolicy, typename Strings>
+    CollationKeys(ExecutionPolicy&& policy, const Strings& strings)
+        : offsets_(strings.size() + 1)
+    {
+        offsets_[0] = 0;
+        ExecutionBackends::transform_inclusive_scan(policy, strings.begin(), strings.end(), offsets_.begin() + 1, std::plus{},
+            [](const auto& str) { return std::string_view(str).size(); });
+
+        chars_.resize(offsets_.back());
+
+        const size_t size = strings.size();
+        const size_t chunks = ExecutionBackends::no_of_chunks(policy, size);
+
+        ExecutionBackends::run_chunks(policy, chunks, [&](size_t chunk) {
+            for (size_t i = ExecutionBackends::chunk_begin(chunk, chunks, size); i < ExecutionBackends::chunk_begin(chunk + 1, chunks, size); ++i)
+            {
+                std::string_view str{strings[i]};
+                fold_case(str.data(), str.size(), chars_.data() + offsets_[i]);
+            }
+        });
+    }
+
+    std::string_view operator[](size_t index) const
+    {
+        return {chars_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]};
+    }
+
+    size_t size() const
+    {
+        return offsets_.size() - 1;
+    }
+};
+
+template <typename ExecutionPolicy, typename Strings>
+std::vector<uint32_t> case_insensitive_order(ExecutionPolicy&& policy, const Strings& strings)
+{
+    const CollationKeys keys{policy, strings};
+
+    std::vector<uint32_t> order(strings.size());
+    std::iota(order.begin(), order.end(), 0);
+    ExecutionBackends::sort(policy, order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    return order;
+}
+
+template <typename ExecutionPolicy, typename T>
+void sort_case_insensitive(ExecutionPolicy&& policy, std::vector<T>& strings)
+{
+    const auto order = case_insensitive_order(policy, strings);
+
+    std::vector<T> sorted(strings.size());
+    ExecutionBackends::transform(policy, order.begin(), order.end(), sorted.begin(), [&](uint32_t i) { return std::move(strings[i]); });
+
+    strings = std::move(sorted);
+}
+
+namespace StringRadixSort
+{
+    constexpr size_t no_of_buckets = 257; // bucket 0 - strings that end before depth
+    constexpr size_t multikey_quicksort_threshold = 64;
+    constexpr size_t insertion_sort_threshold = 12;
+    constexpr size_t parallel_threshold = 1 << 14;
+
+    using Iterator = std::vector<std::string_view>::iterator;
+
+    inline size_t bucket_of(std::string_view str, size_t depth)
+    {
+        return depth < str.size() ? static_cast<unsigned char>(str[depth]) + 1 : 0;
+    }
+
+    inline void insertion_sort(Iterator first, Iterator last, size_t depth)
+    {
+        for (auto it = first; it != last; ++it)
+        {
+            const auto value = *it;
+            auto hole = it;
+
+            for (; hole != first && value.substr(depth) < (hole - 1)->substr(depth); --hole)
+                *hole = *(hole - 1);
+
+            *hole = value;
+        }
+    }
+
+    // Bentley & Sedgewick - three-way partitioning on the character at depth
+    inline void multikey_quicksort(Iterator first, Iterator last, size_t depth)
+    {
+        while (last - first > static_cast<std::ptrdiff_t>(insertion_sort_threshold))
+        {
+            const auto mid = first + (last - first) / 2;
+            size_t a = bucket_of(*first, depth), b = bucket_of(*mid, depth), c = bucket_of(*(last - 1), depth);
+            const size_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+            auto lt = first, gt = last;
+            for (auto it = first; it != gt;)
+            {
+                const size_t key = bucket_of(*it, depth);
+
+                if (key < pivot)
+                    std::iter_swap(lt++, it++);
+                else if (key > pivot)
+                    std::iter_swap(it, --gt);
+                else
+                    ++it;
+            }
+
+            multikey_quicksort(first, lt, depth);
+            multikey_quicksort(gt, last, depth);
+
+            if (pivot == 0) // the equal part holds identical (ended) strings
+                return;
+
+            first = lt;
+            last = gt;
+            ++depth;
+        }
+
+        insertion_sort(first, last, depth);
+    }
+
+    // runs f(task) for task in [0, no_of_tasks) on a custom backend, or with std::execution::par for standard policies
+    // (the tasks allocate, which par_unseq does not allow)
+    template <typename ExecutionPolicy, typename Function>
+    void run_parallel(const ExecutionPolicy& policy, size_t no_of_tasks, Function f)
+    {
+        if constexpr (ExecutionBackends::is_standard_policy<ExecutionPolicy>)
+            ExecutionBackends::run_chunks(std::execution::par, no_of_tasks, f);
+        else
+            ExecutionBackends::run_chunks(policy, no_of_tasks, f);
+    }
+
+    template <typename ExecutionPolicy>
+    void msd_radix_sort(ExecutionPolicy&& policy, Iterator first, Iterator last, Iterator buffer, size_t depth)
+    {
+        const size_t size = last - first;
+
+        if (size < multikey_quicksort_threshold)
+        {
+            multikey_quicksort(first, last, depth);
+            return;
+        }
+
+        constexpr bool is_sequenced = std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>;
+        const bool go_parallel = !is_sequenced && size >= parallel_threshold;
+
+        // per-chunk histograms let the chunks be counted and scattered concurrently
+        const size_t no_of_chunks = go_parallel ? std::max<size_t>(1, std::min<size_t>(size / 4096, 64)) : 1;
+        std::vector<std::array<size_t, no_of_buckets>> positions(no_of_chunks);
+
+        auto chunk_begin = [&](size_t chunk) { return first + chunk * size / no_of_chunks; };
+
+        auto count_chunk = [&](size_t chunk) {
+            positions[chunk].fill(0);
+            for (auto it = chunk_begin(chunk); it != chunk_begin(chunk + 1); ++it)
+                ++positions[chunk][bucket_of(*it, depth)];
+        };
+
+        auto scatter_chunk = [&](size_t chunk) {
+            auto& bucket_positions = positions[chunk];
+            for (auto it = chunk_begin(chunk); it != chunk_begin(chunk + 1); ++it)
+                buffer[bucket_positions[bucket_of(*it, depth)]++] = *it;
+        };
+
+        if (go_parallel)
+            run_parallel(policy, no_of_chunks, count_chunk);
+        else
+            count_chunk(0);
+
+        std::array<size_t, no_of_buckets + 1> bucket_bounds{};
+        for (size_t bucket = 0, position = 0; bucket < no_of_buckets; ++bucket)
+        {
+            bucket_bounds[bucket] = position;
+
+            for (auto& chunk_positions : positions) // counts -> starting positions of every chunk in every bucket
+                position += std::exchange(chunk_positions[bucket], position);
+        }
+        bucket_bounds[no_of_buckets] = size;
+
+        if (go_parallel)
+        {
+            run_parallel(policy, no_of_chunks, scatter_chunk);
+            run_parallel(policy, no_of_chunks, [&](size_t chunk) {
+                std::copy(buffer + (chunk_begin(chunk) - first), buffer + (chunk_begin(chunk + 1) - first), chunk_begin(chunk));
+            });
+        }
+        else
+        {
+            scatter_chunk(0);
+            std::copy(buffer, buffer + size, first);
+        }
+
+        auto sort_bucket = [&](size_t bucket) {
+            msd_radix_sort(policy, first + bucket_bounds[bucket], first + bucket_bounds[bucket + 1], buffer + bucket_bounds[bucket], depth + 1);
+        };
+
+        if (go_parallel) // bucket 0 is already sorted
+            run_parallel(policy, no_of_buckets - 1, [&](size_t bucket) { sort_bucket(bucket + 1); });
+        else
+            for (size_t bucket = 1; bucket < no_of_buckets; ++bucket)
+                sort_bucket(bucket);
+    }
+}
+
+// MSD radix sort (bytewise, like std::string_view::operator<) with multikey quicksort for small buckets
+template <typename ExecutionPolicy>
+void msd_radix_sort(ExecutionPolicy&& policy, std::vector<std::string_view>& strings)
+{
+    std::vector<std::string_view> buffer(strings.size());
+    StringRadixSort::msd_radix_sort(policy, strings.begin(), strings.end(), buffer.begin(), 0);
+}
+
+// Prefix keys: the first 8 bytes of every string packed big-endian into an integer stored next to its index,
+// so most comparisons are a single integer compare on contiguous memory; ties fall back to the full strings
+struct PrefixKey
+{
+    uint64_t prefix;
+    uint32_t index;
+};
+
+inline uint64_t big_endian_prefix(std::string_view str)
+{
+    uint64_t prefix = 0;
+    const size_t length = std::min<size_t>(str.size(), 8);
+
+    for (size_t i = 0; i < length; ++i)
+        prefix |= static_cast<uint64_t>(static_cast<unsigned char>(str[i])) << (56 - 8 * i);
+
+    return prefix;
+}
+
+template <typename ExecutionPolicy>
+void prefix_key_sort(ExecutionPolicy&& policy, std::vector<std::string_view>& strings)
+{
+    std::vector<uint32_t> indexes(strings.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    std::vector<PrefixKey> keys(strings.size());
+    ExecutionBackends::transform(policy, indexes.begin(), indexes.end(), keys.begin(), [&](uint32_t index) {
+        return PrefixKey{big_endian_prefix(strings[index]), index};
+    });
+
+    ExecutionBackends::sort(policy, keys.begin(), keys.end(), [&](const PrefixKey& a, const PrefixKey& b) {
+        if (a.prefix != b.prefix)
+            return a.prefix < b.prefix;
+
+        const std::string_view str_a = strings[a.index];
+        const std::string_view str_b = strings[b.index];
+
+        if (str_a.size() >= 8 && str_b.size() >= 8)
+            return str_a.substr(8) < str_b.substr(8);
+
+        return str_a < str_b; // zero padding of short strings cannot be told apart from '\0' chars
+    });
+
+    std::vector<std::string_view> sorted(strings.size());
+    ExecutionBackends::transform(policy, keys.begin(), keys.end(), sorted.begin(), [&](const PrefixKey& key) { return strings[key.index]; });
+
+    strings = std::move(sorted);
+}
+
+#endif
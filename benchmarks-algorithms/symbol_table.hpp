@@ -0,0 +1,95 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using WordId = uint32_t;
+
+// Maps every distinct token to a dense id (0, 1, 2, ...) in order of first appearance
+class SymbolTable
+{
+    std::deque<std::string> symbols_; // deque never relocates elements - keys of ids_ stay valid
+    std::unordered_map<std::string_view, WordId> ids_;
+
+public:
+    WordId intern(std::string_view token)
+    {
+        if (auto it = ids_.find(token); it != ids_.end())
+            return it->second;
+
+        const auto id = static_cast<WordId>(symbols_.size());
+        const std::string& symbol = symbols_.emplace_back(token);
+        ids_.emplace(symbol, id);
+
+        return id;
+    }
+
+    std::string_view text(WordId id) const
+    {
+        return symbols_[id];
+    }
+
+    size_t size() const
+    {
+        return symbols_.size();
+    }
+
+    // ranks[id] orders ids the same way comp orders their texts (equivalent texts get equal ranks)
+    template <typename Compare>
+    std::vector<uint32_t> ranks(Compare comp) const
+    {
+        std::vector<WordId> ids(size());
+        std::iota(ids.begin(), ids.end(), 0);
+        std::sort(ids.begin(), ids.end(), [&](WordId a, WordId b) { return comp(text(a), text(b)); });
+
+        std::vector<uint32_t> ranks(size());
+        uint32_t rank = 0;
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (i > 0 && comp(text(ids[i - 1]), text(ids[i])))
+                ++rank;
+
+            ranks[ids[i]] = rank;
+        }
+
+        return ranks;
+    }
+};
+
+struct InternedDocument
+{
+    SymbolTable symbols;
+    std::vector<WordId> ids;
+
+    std::string_view operator[](size_t index) const
+    {
+        return symbols.text(ids[index]);
+    }
+
+    size_t size() const
+    {
+        return ids.size();
+    }
+};
+
+template <typename Document>
+InternedDocument intern_words(const Document& words)
+{
+    InternedDocument document;
+    document.ids.reserve(words.size());
+
+    for (const auto& word : words)
+        document.ids.push_back(document.symbols.intern(word));
+
+    return document;
+}
+
+#endif
@@ -0,0 +1,218 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Work-stealing thread pool: every worker owns a deque - it pops its own tasks from the back (LIFO)
+// and steals from the front (FIFO) of the other queues when its own queue is empty
+class ThreadPool
+{
+    using Task = std::function<void()>;
+
+    struct WorkQueue
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> no_of_queued_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<bool> done_{false};
+    std::mutex sleep_mtx_;
+    std::condition_variable work_available_;
+
+    struct WorkerContext
+    {
+        const ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    static WorkerContext& this_worker()
+    {
+        static thread_local WorkerContext context;
+        return context;
+    }
+
+    bool try_pop(size_t index, Task& task, bool steal)
+    {
+        WorkQueue& queue = *queues_[index];
+        std::lock_guard lk{queue.mtx};
+
+        if (queue.tasks.empty())
+            return false;
+
+        if (steal)
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        else
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+
+        --no_of_queued_;
+        return true;
+    }
+
+    void worker_loop(size_t index)
+    {
+        this_worker() = WorkerContext{this, index};
+
+        while (!done_)
+        {
+            if (try_run_one())
+                continue;
+
+            std::unique_lock lk{sleep_mtx_};
+            work_available_.wait(lk, [this] { return no_of_queued_ > 0 || done_; });
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t no_of_threads = std::thread::hardware_concurrency())
+    {
+        no_of_threads = std::max<size_t>(no_of_threads, 1);
+
+        for (size_t i = 0; i < no_of_threads; ++i)
+            queues_.push_back(std::make_unique<WorkQueue>());
+
+        for (size_t i = 0; i < no_of_threads; ++i)
+            threads_.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lk{sleep_mtx_};
+            done_ = true;
+        }
+        work_available_.notify_all();
+
+        for (auto& thd : threads_)
+            thd.join();
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    // tasks submitted from a worker go to its own queue, others are spread round robin
+    void submit(Task task)
+    {
+        const auto& worker = this_worker();
+        const size_t index = (worker.pool == this) ? worker.index : next_queue_++ % queues_.size();
+
+        {
+            std::lock_guard lk{queues_[index]->mtx};
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        ++no_of_queued_;
+
+        {
+            std::lock_guard lk{sleep_mtx_}; // a worker cannot miss the notification between its check and its wait
+        }
+        work_available_.notify_one();
+    }
+
+    // runs one queued task (own queue first, then stealing); used by workers and by threads waiting for a TaskGroup
+    bool try_run_one()
+    {
+        const auto& worker = this_worker();
+        const size_t own_index = (worker.pool == this) ? worker.index : 0;
+        Task task;
+
+        if (worker.pool == this && try_pop(own_index, task, false))
+        {
+            task();
+            return true;
+        }
+
+        for (size_t i = 0; i < queues_.size(); ++i)
+        {
+            if (try_pop((own_index + i) % queues_.size(), task, true))
+            {
+                task();
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+// Fork-join on a ThreadPool - wait() keeps running queued tasks instead of blocking,
+// so nested groups never deadlock; the first exception thrown by a task is rethrown from wait()
+class TaskGroup
+{
+    ThreadPool& pool_;
+    std::atomic<size_t> no_of_pending_{0};
+    std::exception_ptr exception_;
+    std::mutex exception_mtx_;
+
+public:
+    explicit TaskGroup(ThreadPool& pool)
+        : pool_{pool}
+    {
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup()
+    {
+        while (no_of_pending_ > 0)
+            if (!pool_.try_run_one())
+                std::this_thread::yield();
+    }
+
+    template <typename Function>
+    void run(Function f)
+    {
+        ++no_of_pending_;
+
+        pool_.submit([this, f = std::move(f)]() mutable {
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                std::lock_guard lk{exception_mtx_};
+                if (!exception_)
+                    exception_ = std::current_exception();
+            }
+
+            --no_of_pending_;
+        });
+    }
+
+    void wait()
+    {
+        while (no_of_pending_ > 0)
+            if (!pool_.try_run_one())
+                std::this_thread::yield();
+
+        if (exception_)
+            std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef TOKEN_STREAM_HPP
+#define TOKEN_STREAM_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <string_view>
+#include <vector>
+
+#include "tokenizer.hpp"
+
+// Reads whitespace separated tokens from a stream (file, std::cin) in batches - the input is never loaded as a whole.
+// Memory stays within memory_limit: a sixteenth holds the views of a batch, the rest is the chars buffer.
+// Only a token longer than the buffer grows it (to fit the token), tokens are never split.
+class TokenStream
+{
+    std::istream& input_;
+    std::vector<char> buffer_;
+    size_t begin_ = 0; // unconsumed data is [begin_, end_)
+    size_t end_ = 0;
+    size_t batch_size_;
+    std::vector<std::string_view> batch_;
+
+    // called only when the unconsumed data holds no complete token - so at most a partial token is moved
+    void refill()
+    {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+
+        while (end_ < buffer_.size() && input_)
+        {
+            input_.read(buffer_.data() + end_, buffer_.size() - end_);
+            end_ += input_.gcount();
+        }
+    }
+
+public:
+    static constexpr size_t default_memory_limit = 1 << 20; // 960 KiB buffer + batches of 4096 tokens
+
+    explicit TokenStream(std::istream& input, size_t memory_limit = default_memory_limit)
+        : input_{input},
+          buffer_(std::max<size_t>(memory_limit - memory_limit / 16, 1)),
+          batch_size_{std::max<size_t>(memory_limit / 16 / sizeof(std::string_view), 1)}
+    {
+        batch_.reserve(batch_size_);
+    }
+
+    // returns an empty batch at the end of input; views are valid until the next call
+    const std::vector<std::string_view>& next_batch()
+    {
+        batch_.clear();
+
+        while (true)
+        {
+            const char* const data = buffer_.data();
+            const bool input_exhausted = !input_;
+            bool needs_more_input = false;
+
+            while (batch_.size() < batch_size_)
+            {
+                const char* token_start = whitespace_separators.find_first_not_separator(data + begin_, data + end_);
+                begin_ = token_start - data;
+
+                if (begin_ == end_)
+                {
+                    needs_more_input = !input_exhausted;
+                    break;
+                }
+
+                const char* token_end = whitespace_separators.find_first_separator(token_start, data + end_);
+
+                if (token_end == data + end_ && !input_exhausted)
+                {
+                    if (begin_ == 0) // the token fills the whole buffer (so the batch is still empty)
+                        buffer_.resize(2 * buffer_.size());
+
+                    needs_more_input = true; // the token may continue past the buffer
+                    break;
+                }
+
+                batch_.emplace_back(token_start, token_end - token_start);
+                begin_ = token_end - data;
+            }
+
+            if (!batch_.empty() || !needs_more_input)
+                return batch_;
+
+            refill();
+        }
+    }
+};
+
+// Calls f(batch) for every batch of the stream
+template <typename Function>
+void for_each_batch(TokenStream& tokens, Function f)
+{
+    for (const auto* batch = &tokens.next_batch(); !batch->empty(); batch = &tokens.next_batch())
+        f(*batch);
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef TOKENIZER_HPP
+#define TOKENIZER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "separators.hpp"
+
+// the same set of characters that std::isspace() accepts in the "C" locale - used by operator>>
+constexpr bool is_whitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline constexpr SeparatorSet whitespace_separators{" \n\t\r\v\f"};
+
+// Token boundaries are taken from transitions in the separator bitmask - 64 bytes per step
+inline void split_words(std::string_view text, std::vector<std::string_view>& tokens)
+{
+    const char* const data = text.data();
+    bool in_token = false;
+    size_t token_start = 0;
+    size_t pos = 0;
+
+    for (; pos + 64 <= text.size(); pos += 64)
+    {
+        const uint64_t token_mask = ~whitespace_separators.mask64(data + pos);
+        const uint64_t previous_mask = (token_mask << 1) | static_cast<uint64_t>(in_token);
+
+        uint64_t starts = token_mask & ~previous_mask;
+        uint64_t ends = ~token_mask & previous_mask;
+
+        while (true)
+        {
+            if (in_token)
+            {
+                if (!ends)
+                    break;
+
+                tokens.emplace_back(data + token_start, pos + count_trailing_zeros(ends) - token_start);
+                ends &= ends - 1;
+                in_token = false;
+            }
+            else
+            {
+                if (!starts)
+                    break;
+
+                token_start = pos + count_trailing_zeros(starts);
+                starts &= starts - 1;
+                in_token = true;
+            }
+        }
+    }
+
+    for (; pos < text.size(); ++pos)
+    {
+        if (in_token == is_whitespace(data[pos]))
+        {
+            if (in_token)
+                tokens.emplace_back(data + token_start, pos - token_start);
+            else
+                token_start = pos;
+
+            in_token = !in_token;
+        }
+    }
+
+    if (in_token)
+        tokens.emplace_back(data + token_start, pos - token_start);
+}
+
+inline std::vector<std::string_view> split_words(std::string_view text)
+{
+    std::vector<std::string_view> tokens;
+    split_words(text, tokens);
+
+    return tokens;
+}
+
+// Splits text into per-core chunks aligned to whitespace, tokenizes them concurrently
+// and stitches the results back in the original order
+inline std::vector<std::string_view> split_words_parallel(std::string_view text, size_t no_of_chunks = std::thread::hardware_concurrency())
+{
+    const size_t min_chunk_size = 64 * 1024; // smaller chunks cost more in scheduling than they save
+
+    no_of_chunks = std::clamp<size_t>(no_of_chunks, 1, text.size() / min_chunk_size + 1);
+
+    std::vector<size_t> chunk_bounds(no_of_chunks + 1, text.size());
+    chunk_bounds[0] = 0;
+
+    for (size_t i = 1; i < no_of_chunks; ++i)
+    {
+        size_t bound = std::max(chunk_bounds[i - 1], i * (text.size() / no_of_chunks));
+
+        while (bound < text.size() && !is_whitespace(text[bound]))
+            ++bound;
+
+        chunk_bounds[i] = bound;
+    }
+
+    std::vector<size_t> chunk_indexes(no_of_chunks);
+    std::iota(chunk_indexes.begin(), chunk_indexes.end(), 0);
+
+    std::vector<std::vector<std::string_view>> chunk_tokens(no_of_chunks);
+
+    std::for_each(std::execution::par, chunk_indexes.begin(), chunk_indexes.end(), [&](size_t i) {
+        split_words(text.substr(chunk_bounds[i], chunk_bounds[i + 1] - chunk_bounds[i]), chunk_tokens[i]);
+    });
+
+    std::vector<size_t> chunk_offsets(no_of_chunks);
+    std::transform_exclusive_scan(chunk_tokens.begin(), chunk_tokens.end(), chunk_offsets.begin(), size_t{0}, std::plus{},
+        [](const auto& tokens) { return tokens.size(); });
+
+    std::vector<std::string_view> tokens(chunk_offsets.back() + chunk_tokens.back().size());
+
+    std::for_each(std::execution::par, chunk_indexes.begin(), chunk_indexes.end(), [&](size_t i) {
+        std::copy(chunk_tokens[i].begin(), chunk_tokens[i].end(), tokens.begin() + chunk_offsets[i]);
+    });
+
+    return tokens;
+}
+
+#endif
@@ -0,0 +1,31 @@
+// Converts a whitespace separated text file into the binary corpus format (see binary_corpus.hpp)
+//   usage: make_corpus <tokens.txt> <tokens.bin>
+
+#include <iostream>
+
+#include "../binary_corpus.hpp"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <input text file> <output corpus file>\n";
+        return 1;
+    }
+
+    auto words = load_words_mapped(argv[1]);
+
+    if (!words)
+    {
+        std::cerr << "cannot read " << argv[1] << "\n";
+        return 1;
+    }
+
+    if (!write_corpus(argv[2], *words))
+    {
+        std::cerr << "cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::cout << "Corpus " << argv[2] << ": " << words->size() << " tokens\n";
+}
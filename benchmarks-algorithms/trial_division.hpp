@@ -0,0 +1,210 @@
+#ifndef TRIAL_DIVISION_HPP
+#define TRIAL_DIVISION_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "execution_backends.hpp"
+#include "miller_rabin.hpp"
+#include "wide_arithmetic.hpp"
+
+// Batched primality: candidates are divided by the wheel primes 2, 3, 5, 7 (n survives the wheel iff it is coprime to 210)
+// and by the rest of the primes below 256, eight 32-bit lanes at a time with AVX2.
+// Division is replaced by multiplication with the precomputed modular inverse: for an odd prime p,
+// p divides n iff n * inverse(p) mod 2^32 <= (2^32 - 1) / p.
+// Numbers without a small factor below 257^2 are primes, the remaining survivors go to Miller-Rabin.
+namespace TrialDivision
+{
+    constexpr size_t no_of_lanes = 8;
+    constexpr uint64_t table_bound = 256;
+    constexpr uint64_t proven_prime_bound = 257 * 257; // 257 is the first prime above the table
+
+    struct Divisor
+    {
+        uint32_t prime;
+        uint32_t inverse_32; // prime * inverse_32 == 1 (mod 2^32)
+        uint32_t max_quotient_32;
+        uint64_t inverse_64; // prime * inverse_64 == 1 (mod 2^64)
+        uint64_t max_quotient_64;
+    };
+
+    constexpr size_t no_of_odd_primes = 53; // 3, 5, 7 (wheel), 11 ... 251
+
+    constexpr std::array<Divisor, no_of_odd_primes> make_divisors()
+    {
+        std::array<Divisor, no_of_odd_primes> divisors{};
+        size_t count = 0;
+
+        for (uint32_t n = 3; n < table_bound; n += 2)
+        {
+            bool is_prime = true;
+            for (uint32_t d = 3; d * d <= n; d += 2)
+                if (n % d == 0)
+                    is_prime = false;
+
+            if (!is_prime)
+                continue;
+
+            const uint64_t inverse = WideArithmetic::inverse_mod_2_64(n);
+            divisors[count++] = Divisor{n, static_cast<uint32_t>(inverse), UINT32_MAX / n, inverse, UINT64_MAX / n};
+        }
+
+        return divisors;
+    }
+
+    inline constexpr std::array<Divisor, no_of_odd_primes> divisors = make_divisors();
+    static_assert(divisors.back().prime == 251, "all odd primes below table_bound are in the table");
+
+    enum class Verdict : uint8_t
+    {
+        composite,
+        prime,
+        unknown // no factor below table_bound, too large to be proven prime by that
+    };
+
+    inline Verdict classify(uint64_t n)
+    {
+        if (n < 2 || (n % 2 == 0 && n != 2))
+            return Verdict::composite;
+
+        for (const auto& divisor : divisors)
+            if (n * divisor.inverse_64 <= divisor.max_quotient_64 && n != divisor.prime)
+                return Verdict::composite;
+
+        return n < proven_prime_bound ? Verdict::prime : Verdict::unknown;
+    }
+
+    inline bool finish(uint64_t n, Verdict verdict)
+    {
+        return verdict == Verdict::prime || (verdict == Verdict::unknown && MillerRabin::passes_witnesses(n));
+    }
+
+#if defined(__AVX2__)
+    // n <= limit for unsigned 32-bit lanes
+    inline __m256i less_equal_epu32(__m256i n, __m256i limit)
+    {
+        return _mm256_cmpeq_epi32(_mm256_min_epu32(n, limit), n);
+    }
+
+    // bit masks of the lanes with a small factor (composites) and of the lanes proven prime
+    inline void classify_lanes(const uint32_t* numbers, uint32_t& composite_mask, uint32_t& prime_mask)
+    {
+        const __m256i n = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(numbers));
+
+        const __m256i is_even = _mm256_cmpeq_epi32(_mm256_and_si256(n, _mm256_set1_epi32(1)), _mm256_setzero_si256());
+        const __m256i is_two = _mm256_cmpeq_epi32(n, _mm256_set1_epi32(2));
+        __m256i composite = _mm256_or_si256(_mm256_andnot_si256(is_two, is_even), less_equal_epu32(n, _mm256_set1_epi32(1)));
+
+        for (const auto& divisor : divisors)
+        {
+            const __m256i quotient = _mm256_mullo_epi32(n, _mm256_set1_epi32(static_cast<int>(divisor.inverse_32)));
+            const __m256i divisible = less_equal_epu32(quotient, _mm256_set1_epi32(static_cast<int>(divisor.max_quotient_32)));
+            const __m256i is_divisor = _mm256_cmpeq_epi32(n, _mm256_set1_epi32(static_cast<int>(divisor.prime)));
+            composite = _mm256_or_si256(composite, _mm256_andnot_si256(is_divisor, divisible));
+        }
+
+        const __m256i small = less_equal_epu32(n, _mm256_set1_epi32(static_cast<int>(proven_prime_bound - 1)));
+
+        composite_mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(composite)));
+        prime_mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(composite, small))));
+    }
+#else
+    inline void classify_lanes(const uint32_t* numbers, uint32_t& composite_mask, uint32_t& prime_mask)
+    {
+        composite_mask = prime_mask = 0;
+
+        for (size_t lane = 0; lane < no_of_lanes; ++lane)
+        {
+            const uint32_t n = numbers[lane];
+            bool composite = n < 2 || (n % 2 == 0 && n != 2);
+
+            for (const auto& divisor : divisors)
+                composite |= static_cast<uint32_t>(n * divisor.inverse_32) <= divisor.max_quotient_32 && n != divisor.prime;
+
+            composite_mask |= static_cast<uint32_t>(composite) << lane;
+            prime_mask |= static_cast<uint32_t>(!composite && n < proven_prime_bound) << lane;
+        }
+    }
+#endif
+
+    // out[i] = primality of first[i] for i in [0, count)
+    template <typename Iterator, typename OutputIterator>
+    void are_primes(Iterator first, size_t count, OutputIterator out)
+    {
+        size_t index = 0;
+
+        for (; index + no_of_lanes <= count; index += no_of_lanes)
+        {
+            alignas(32) uint32_t lanes[no_of_lanes];
+            bool fits_32_bits = true;
+
+            for (size_t lane = 0; lane < no_of_lanes; ++lane)
+            {
+                const uint64_t n = first[index + lane];
+                fits_32_bits &= n <= UINT32_MAX;
+                lanes[lane] = static_cast<uint32_t>(n);
+            }
+
+            if (!fits_32_bits)
+            {
+                for (size_t lane = 0; lane < no_of_lanes; ++lane)
+                    out[index + lane] = finish(first[index + lane], classify(first[index + lane]));
+                continue;
+            }
+
+            uint32_t composite_mask, prime_mask;
+            classify_lanes(lanes, composite_mask, prime_mask);
+
+            for (size_t lane = 0; lane < no_of_lanes; ++lane)
+            {
+                Verdict verdict = Verdict::unknown;
+                if ((composite_mask >> lane) & 1)
+                    verdict = Verdict::composite;
+                else if ((prime_mask >> lane) & 1)
+                    verdict = Verdict::prime;
+
+                out[index + lane] = finish(lanes[lane], verdict);
+            }
+        }
+
+        for (; index < count; ++index)
+            out[index] = finish(first[index], classify(first[index]));
+    }
+}
+
+// Batch API: out[i] = primality of first[i]; chunks of lane groups run under any execution policy or custom backend
+template <typename Policy, typename Iterator, typename OutputIterator>
+OutputIterator are_primes_trial_division(Policy&& policy, Iterator first, Iterator last, OutputIterator out)
+{
+    using namespace ExecutionBackends;
+
+    const size_t size = last - first;
+    const size_t no_of_groups = (size + TrialDivision::no_of_lanes - 1) / TrialDivision::no_of_lanes;
+    const size_t chunks = no_of_chunks(policy, no_of_groups);
+
+    run_chunks(policy, chunks, [&](size_t chunk) {
+        const size_t begin = std::min(chunk_begin(chunk, chunks, no_of_groups) * TrialDivision::no_of_lanes, size);
+        const size_t end = std::min(chunk_begin(chunk + 1, chunks, no_of_groups) * TrialDivision::no_of_lanes, size);
+        TrialDivision::are_primes(first + begin, end - begin, out + begin);
+    });
+
+    return out + size;
+}
+
+// Stable partition of the primes to the front, primality decided by the batched kernel
+template <typename Policy, typename Iterator>
+Iterator partition_primes(Policy&& policy, Iterator first, Iterator last)
+{
+    std::vector<uint8_t> flags(last - first);
+    are_primes_trial_division(policy, first, last, flags.begin());
+
+    return ExecutionBackends::partition_by_flags(policy, first, last, flags.begin());
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef WIDE_ARITHMETIC_HPP
+#define WIDE_ARITHMETIC_HPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 64-bit arithmetic beyond the built-in operators: the full 128-bit product and inverses modulo 2^64
+namespace WideArithmetic
+{
+    struct Product
+    {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    // a * b as two 64-bit halves - a single instruction where the compiler offers one, four 32x32->64 bit multiplies otherwise
+    inline Product multiply(uint64_t a, uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t high;
+        const uint64_t low = _umul128(a, b, &high);
+        return {low, high};
+#else
+        const uint64_t a_lo = static_cast<uint32_t>(a), a_hi = a >> 32, b_lo = static_cast<uint32_t>(b), b_hi = b >> 32;
+        const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+        const uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+        return {(cross << 32) | static_cast<uint32_t>(lo_lo), hi_hi + (hi_lo >> 32) + (cross >> 32)};
+#endif
+    }
+
+    // high 64 bits of a * b
+    inline uint64_t mul_high(uint64_t a, uint64_t b)
+    {
+        return multiply(a, b).high;
+    }
+
+    // x with n * x == 1 (mod 2^64) for an odd n
+    constexpr uint64_t inverse_mod_2_64(uint64_t n)
+    {
+        uint64_t inverse = n; // correct in the low 3 bits, Newton iteration doubles them: 3 -> 6 -> ... -> 96
+        for (int i = 0; i < 5; ++i)
+            inverse *= 2 - n * inverse;
+
+        return inverse;
+    }
+
+    static_assert(inverse_mod_2_64(3) * 3 == 1 && inverse_mod_2_64(0xFFFFFFFFFFFFFFC5ull) * 0xFFFFFFFFFFFFFFC5ull == 1);
+}
+
+#endif
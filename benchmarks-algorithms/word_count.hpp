@@ -0,0 +1,288 @@
+#ifndef WORD_COUNT_HPP
+#define WORD_COUNT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "fast_hash.hpp"
+#include "parallel_merge_sort.hpp"
+#include "symbol_table.hpp"
+#include "thread_pool.hpp"
+
+using WordCounts = std::unordered_map<std::string_view, size_t, FastHash>;
+
+enum class CountingStrategy
+{
+    thread_local_maps, // every thread counts its chunk in a private map, the maps are merged at the end
+    sharded_map,       // one map split into shards, every shard guarded by its own mutex
+    lock_free_table,   // open addressing table with atomic slots (CAS on the key, fetch_add on the count)
+    sort_and_count     // parallel merge sort of the words, then run-length counting
+};
+
+namespace WordCounting
+{
+    // calls f(chunk, first, last) for pool.size() contiguous chunks of [0, size) on the pool
+    template <typename Function>
+    void for_each_chunk(ThreadPool& pool, size_t size, Function f)
+    {
+        const size_t no_of_chunks = std::max<size_t>(std::min(pool.size(), size), 1);
+
+        TaskGroup group{pool};
+        for (size_t chunk = 0; chunk < no_of_chunks; ++chunk)
+            group.run([=] { f(chunk, chunk * size / no_of_chunks, (chunk + 1) * size / no_of_chunks); });
+        group.wait();
+    }
+
+    template <typename Words>
+    WordCounts count_thread_local(ThreadPool& pool, const Words& words)
+    {
+        std::vector<WordCounts> partial_counts(std::max<size_t>(pool.size(), 1));
+
+        for_each_chunk(pool, words.size(), [&](size_t chunk, size_t first, size_t last) {
+            auto& counts = partial_counts[chunk];
+
+            for (size_t i = first; i < last; ++i)
+                ++counts[words[i]];
+        });
+
+        WordCounts counts = std::move(partial_counts.front());
+        for (auto it = partial_counts.begin() + 1; it != partial_counts.end(); ++it)
+            for (const auto& [word, count] : *it)
+                counts[word] += count;
+
+        return counts;
+    }
+
+    template <typename Words>
+    WordCounts count_sharded(ThreadPool& pool, const Words& words, size_t no_of_shards = 64)
+    {
+        struct Shard
+        {
+            std::mutex mtx;
+            WordCounts counts;
+        };
+
+        std::vector<Shard> shards(no_of_shards);
+
+        for_each_chunk(pool, words.size(), [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+            {
+                const std::string_view word = words[i];
+                auto& shard = shards[FastHash{}(word) % no_of_shards];
+
+                std::lock_guard lk{shard.mtx};
+                ++shard.counts[word];
+            }
+        });
+
+        WordCounts counts;
+        for (auto& shard : shards)
+            counts.merge(shard.counts); // shards hold disjoint words
+
+        return counts;
+    }
+
+    // Fixed capacity (a power of two) open addressing table with linear probing; a slot key packs the upper half of
+    // the word hash with (index of the first occurrence + 1), so most mismatches are rejected without comparing text.
+    // The table is full once half of its slots hold keys - add() then fails and the caller retries with a larger one.
+    template <typename Words>
+    class LockFreeTable
+    {
+        const Words& words_;
+        std::unique_ptr<std::atomic<uint64_t>[]> keys_;
+        std::unique_ptr<std::atomic<size_t>[]> counts_;
+        size_t mask_;
+        std::atomic<size_t> no_of_keys_{0};
+
+    public:
+        LockFreeTable(const Words& words, size_t capacity)
+            : words_{words}
+        {
+            size_t size = 16;
+            while (size < capacity)
+                size *= 2;
+
+            keys_ = std::make_unique<std::atomic<uint64_t>[]>(size);
+            counts_ = std::make_unique<std::atomic<size_t>[]>(size);
+            mask_ = size - 1;
+
+            for (size_t slot = 0; slot < size; ++slot)
+            {
+                keys_[slot].store(0, std::memory_order_relaxed);
+                counts_[slot].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        size_t capacity() const
+        {
+            return mask_ + 1;
+        }
+
+        // false if the table is full (the word may or may not have been counted)
+        bool add(size_t index)
+        {
+            const std::string_view word = words_[index];
+            const uint64_t hash = FastHash{}(word);
+            const uint64_t key = (hash & 0xFFFFFFFF00000000ull) | (index + 1);
+
+            for (size_t slot = hash & mask_, no_of_probes = 0; no_of_probes <= mask_; slot = (slot + 1) & mask_, ++no_of_probes)
+            {
+                uint64_t slot_key = keys_[slot].load(std::memory_order_acquire);
+
+                if (slot_key == 0 && keys_[slot].compare_exchange_strong(slot_key, key, std::memory_order_acq_rel))
+                {
+                    if (no_of_keys_.fetch_add(1, std::memory_order_relaxed) >= capacity() / 2)
+                        return false;
+
+                    slot_key = key;
+                }
+
+                if ((slot_key >> 32) == (hash >> 32) && words_[(slot_key & 0xFFFFFFFF) - 1] == word)
+                {
+                    counts_[slot].fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        WordCounts counts() const
+        {
+            WordCounts counts;
+            counts.reserve(no_of_keys_.load(std::memory_order_relaxed));
+
+            for (size_t slot = 0; slot <= mask_; ++slot)
+                if (const uint64_t key = keys_[slot].load(std::memory_order_relaxed); key != 0)
+                    counts.emplace(words_[(key & 0xFFFFFFFF) - 1], counts_[slot].load(std::memory_order_relaxed));
+
+            return counts;
+        }
+    };
+
+    constexpr size_t distinct_sample_size = 1 << 16;
+
+    // Vocabulary grows slower than the text, so twice the distinct words of a leading sample is a generous estimate
+    // for most inputs; a table sized from it that still fills up is rebuilt at four times the size
+    template <typename Words>
+    size_t estimate_distinct(const Words& words)
+    {
+        const size_t sample_size = std::min(words.size(), distinct_sample_size);
+
+        std::unordered_set<std::string_view, FastHash> distinct;
+        for (size_t i = 0; i < sample_size; ++i)
+            distinct.insert(words[i]);
+
+        return sample_size == words.size() ? distinct.size() : 2 * distinct.size();
+    }
+
+    // distinct_hint - expected number of distinct words, estimated from a sample when 0
+    template <typename Words>
+    WordCounts count_lock_free(ThreadPool& pool, const Words& words, size_t distinct_hint = 0)
+    {
+        if (words.size() >= 0xFFFFFFFF)
+            throw std::length_error("LockFreeTable indexes words with 32 bits");
+
+        size_t capacity = 2 * std::max<size_t>(distinct_hint != 0 ? distinct_hint : estimate_distinct(words), 1);
+
+        while (true)
+        {
+            LockFreeTable table{words, capacity};
+            std::atomic<bool> full{false};
+
+            for_each_chunk(pool, words.size(), [&](size_t, size_t first, size_t last) {
+                for (size_t i = first; i < last && !full.load(std::memory_order_relaxed); ++i)
+                    if (!table.add(i))
+                        full.store(true, std::memory_order_relaxed);
+            });
+
+            if (!full)
+                return table.counts();
+
+            capacity = 4 * table.capacity();
+        }
+    }
+
+    template <typename Words>
+    WordCounts count_sorted(ThreadPool& pool, const Words& words)
+    {
+        std::vector<std::string_view> sorted(words.size());
+        for_each_chunk(pool, words.size(), [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+                sorted[i] = words[i];
+        });
+
+        parallel_merge_sort(pool, sorted.begin(), sorted.end());
+
+        WordCounts counts;
+        for (auto first = sorted.begin(); first != sorted.end();)
+        {
+            const auto last = std::find_if(first, sorted.end(), [&](std::string_view word) { return word != *first; });
+            counts.emplace(*first, last - first);
+            first = last;
+        }
+
+        return counts;
+    }
+}
+
+// Frequencies of interned words indexed by id: every thread counts its chunk into a private dense array
+// (no hashing or string compares), then the arrays are summed in parallel over ranges of ids
+inline std::vector<size_t> count_ids(ThreadPool& pool, const InternedDocument& document)
+{
+    using namespace WordCounting;
+
+    const auto& ids = document.ids;
+    const size_t no_of_symbols = document.symbols.size();
+    std::vector<std::vector<size_t>> partial_counts(std::max<size_t>(pool.size(), 1));
+
+    for_each_chunk(pool, ids.size(), [&](size_t chunk, size_t first, size_t last) {
+        auto& counts = partial_counts[chunk];
+        counts.assign(no_of_symbols, 0);
+
+        for (size_t i = first; i < last; ++i)
+            ++counts[ids[i]];
+    });
+
+    std::vector<size_t> counts(no_of_symbols, 0);
+    for_each_chunk(pool, no_of_symbols, [&](size_t, size_t first, size_t last) {
+        for (const auto& partial : partial_counts)
+            if (!partial.empty()) // chunks without words never allocate
+                for (size_t id = first; id < last; ++id)
+                    counts[id] += partial[id];
+    });
+
+    return counts;
+}
+
+// Word frequencies of words (random access container of anything convertible to std::string_view) counted on the pool;
+// the keys of the result view the words
+template <typename Words>
+WordCounts count_words(CountingStrategy strategy, ThreadPool& pool, const Words& words)
+{
+    using namespace WordCounting;
+
+    switch (strategy)
+    {
+    case CountingStrategy::thread_local_maps:
+        return count_thread_local(pool, words);
+    case CountingStrategy::sharded_map:
+        return count_sharded(pool, words);
+    case CountingStrategy::lock_free_table:
+        return count_lock_free(pool, words);
+    case CountingStrategy::sort_and_count:
+        return count_sorted(pool, words);
+    }
+
+    throw std::invalid_argument("Unknown counting strategy");
+}
+
+#endif